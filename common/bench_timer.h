@@ -0,0 +1,205 @@
+#ifndef BENCH_TIMER_H
+#define BENCH_TIMER_H
+
+// Repeatable timing harness shared by the sorting drivers (exp1b, exp2a).
+//
+// bench_measure() runs `prepare` and then times `run` for `warmup` untimed
+// and `reps` timed repetitions. `prepare` is where each repetition gets a
+// fresh copy of its input, so the copy never lands inside the timed region.
+// Times come from the monotonic clock at nanosecond resolution instead of
+// clock(), whose millisecond ticks round most small blocks down to 0.
+//
+// If config.counters points at opened PerfCounters (common/perf_counters.h)
+// they are read around every timed repetition as well, and the median per
+// counter is reported in stats.counters.
+//
+// BENCH_WARMUP / BENCH_REPS in the environment override the defaults.
+// C drivers must define _GNU_SOURCE before their first #include for CPU
+// pinning to be available on Linux. No libm is needed.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "perf_counters.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#if defined(__linux__) && defined(_GNU_SOURCE)
+#include <sched.h>
+#define BENCH_HAVE_AFFINITY 1
+#endif
+#endif
+
+#define BENCH_DEFAULT_WARMUP 1
+#define BENCH_DEFAULT_REPS 5
+
+typedef struct {
+    int warmup;
+    int reps;
+    PerfCounters* counters; // NULL to skip hardware counters
+} BenchConfig;
+
+typedef struct {
+    double min_ms;
+    double median_ms;
+    double p95_ms;
+    double mean_ms;
+    double stddev_ms;
+    int reps;
+    PerfSample counters; // median per repetition, -1 where unavailable
+} BenchStats;
+
+static inline double bench_now_ms(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1e6;
+#endif
+}
+
+static inline BenchConfig bench_default_config(void) {
+    BenchConfig config = {BENCH_DEFAULT_WARMUP, BENCH_DEFAULT_REPS, NULL};
+    const char* warmup = getenv("BENCH_WARMUP");
+    const char* reps = getenv("BENCH_REPS");
+    if (warmup != NULL && atoi(warmup) >= 0) config.warmup = atoi(warmup);
+    if (reps != NULL && atoi(reps) > 0) config.reps = atoi(reps);
+    return config;
+}
+
+// Pins the calling thread to `cpu` so repetitions are not migrated between
+// cores mid-run. Returns 0 on success, -1 where pinning is unsupported.
+static inline int bench_pin_to_cpu(int cpu) {
+#if defined(BENCH_HAVE_AFFINITY)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0 ? 0 : -1;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0 ? 0 : -1;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+static inline double bench_sqrt(double x) {
+    if (x <= 0) return 0;
+    double r = x > 1 ? x : 1;
+    for (int i = 0; i < 64; i++) {
+        double next = 0.5 * (r + x / r);
+        if (next >= r) break;
+        r = next;
+    }
+    return r;
+}
+
+static inline int bench_compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Fills `stats` from `n` samples; sorts the samples in place.
+static inline void bench_summarize(double* samples, int n, BenchStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    perf_sample_clear(&stats->counters);
+    stats->reps = n;
+    if (n <= 0) return;
+
+    qsort(samples, n, sizeof(double), bench_compare_doubles);
+    double sum = 0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+    stats->mean_ms = sum / n;
+
+    double var = 0;
+    for (int i = 0; i < n; i++) var += (samples[i] - stats->mean_ms) * (samples[i] - stats->mean_ms);
+    stats->stddev_ms = (n > 1) ? bench_sqrt(var / (n - 1)) : 0;
+
+    stats->min_ms = samples[0];
+    stats->median_ms = (n % 2) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+    int p95 = (95 * n + 99) / 100 - 1; // nearest rank
+    stats->p95_ms = samples[p95];
+}
+
+static inline int bench_compare_long_longs(const void* a, const void* b) {
+    long long x = *(const long long*)a, y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+static inline void bench_measure(const BenchConfig* config, void (*prepare)(void*), void (*run)(void*), void* ctx, BenchStats* stats) {
+    for (int i = 0; i < config->warmup; i++) {
+        if (prepare != NULL) prepare(ctx);
+        run(ctx);
+    }
+
+    int reps = config->reps;
+    double* samples = (double*)malloc(reps * sizeof(double));
+    PerfSample* counter_samples = (PerfSample*)malloc(reps * sizeof(PerfSample));
+    long long* values = (long long*)malloc(reps * sizeof(long long));
+    if (samples == NULL || counter_samples == NULL || values == NULL) {
+        free(samples);
+        free(counter_samples);
+        free(values);
+        bench_summarize(NULL, 0, stats);
+        return;
+    }
+    for (int i = 0; i < reps; i++) {
+        if (prepare != NULL) prepare(ctx);
+        if (config->counters != NULL) perf_counters_start(config->counters);
+        double start = bench_now_ms();
+        run(ctx);
+        samples[i] = bench_now_ms() - start;
+        if (config->counters != NULL) perf_counters_stop(config->counters, &counter_samples[i]);
+        else perf_sample_clear(&counter_samples[i]);
+    }
+    bench_summarize(samples, reps, stats);
+
+    for (int c = 0; c < PERF_NUM_COUNTERS; c++) {
+        int n = 0;
+        for (int i = 0; i < reps; i++)
+            if (counter_samples[i].value[c] >= 0) values[n++] = counter_samples[i].value[c];
+        if (n == 0) continue;
+        qsort(values, n, sizeof(long long), bench_compare_long_longs);
+        stats->counters.value[c] = values[n / 2];
+    }
+    free(samples);
+    free(counter_samples);
+    free(values);
+}
+
+// Opens the hardware counters for `config`, or explains why the counter
+// columns will be NA. Release with perf_counters_close.
+static inline void bench_enable_counters(BenchConfig* config, PerfCounters* counters) {
+    if (perf_counters_open(counters) > 0) {
+        config->counters = counters;
+        if (counters->available < PERF_NUM_COUNTERS)
+            printf("Only %d of %d performance counters available, the rest are NA\n", counters->available, PERF_NUM_COUNTERS);
+    } else {
+        config->counters = NULL;
+        printf("Performance counters unavailable, counter columns are NA\n");
+    }
+}
+
+// Column headers / values for one measured series, e.g.
+//   "Insertion Sort Median (ms),Insertion Sort Min (ms),..."
+static inline void bench_csv_header(FILE* file, const char* name) {
+    fprintf(file, ",%s Median (ms),%s Min (ms),%s P95 (ms),%s Stddev (ms)", name, name, name, name);
+}
+
+static inline void bench_csv_stats(FILE* file, const BenchStats* stats) {
+    fprintf(file, ",%.6f,%.6f,%.6f,%.6f", stats->median_ms, stats->min_ms, stats->p95_ms, stats->stddev_ms);
+}
+
+#endif
@@ -0,0 +1,27 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dataset.h"
+
+// One-time converter from the text files the benchmarks used to write
+// (e.g. exp2a/random_numbers.txt) to the binary dataset format.
+//
+// Usage: convert_dataset <input.txt> <output.bin> [seed] [int32|int64]
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        printf("Usage: %s <input.txt> <output.bin> [seed] [int32|int64]\n", argv[0]);
+        return 1;
+    }
+
+    uint64_t seed = (argc > 3) ? strtoull(argv[3], NULL, 10) : 0;
+    uint32_t elem_type = (argc > 4 && strcmp(argv[4], "int64") == 0) ? DATASET_INT64 : DATASET_INT32;
+
+    long long count = dataset_convert_text(argv[1], argv[2], elem_type, seed);
+    if (count < 0) {
+        printf("Error converting %s to %s!\n", argv[1], argv[2]);
+        return 1;
+    }
+
+    printf("Wrote %lld values to %s\n", count, argv[2]);
+    return 0;
+}
@@ -0,0 +1,210 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+// Binary dataset format shared by the sorting benchmarks (exp1b, exp2a).
+//
+// Layout (little-endian):
+//   DatasetHeader (32 bytes) followed by `count` elements of `elem_type`.
+//
+// Readers map the file once and slice the first blockSize elements instead
+// of re-parsing a text file for every block size. On Windows the file is
+// read into a heap buffer instead of being mapped.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define DATASET_MAGIC "DAASORT1"
+
+enum {
+    DATASET_INT32 = 1,
+    DATASET_INT64 = 2
+};
+
+typedef struct {
+    char magic[8];      // DATASET_MAGIC, not NUL-terminated
+    uint64_t count;     // number of elements after the header
+    uint32_t elem_type; // DATASET_INT32 or DATASET_INT64
+    uint32_t reserved;
+    uint64_t seed;      // seed the generator was run with, 0 if unknown
+} DatasetHeader;
+
+typedef struct {
+    DatasetHeader header;
+    const void* data;   // first element
+    void* base;         // mapping (or heap buffer) that holds the whole file
+    size_t size;        // size of the mapping in bytes
+} Dataset;
+
+static inline int dataset_host_is_little_endian(void) {
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+static inline size_t dataset_elem_size(uint32_t elem_type) {
+    switch (elem_type) {
+    case DATASET_INT32: return 4;
+    case DATASET_INT64: return 8;
+    default: return 0;
+    }
+}
+
+// Streaming counterparts of dataset_write/dataset_open for files that are
+// produced or consumed in chunks. Both return 0 on success.
+static inline int dataset_write_header(FILE* file, uint64_t count, uint32_t elem_type, uint64_t seed) {
+    DatasetHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DATASET_MAGIC, sizeof(header.magic));
+    header.count = count;
+    header.elem_type = elem_type;
+    header.seed = seed;
+    return fwrite(&header, sizeof(header), 1, file) == 1 ? 0 : -1;
+}
+
+static inline int dataset_read_header(FILE* file, DatasetHeader* header) {
+    if (!dataset_host_is_little_endian() || fread(header, sizeof(*header), 1, file) != 1) return -1;
+    if (memcmp(header->magic, DATASET_MAGIC, sizeof(header->magic)) != 0 || dataset_elem_size(header->elem_type) == 0)
+        return -1;
+    return 0;
+}
+
+// Writes `count` elements of `elem_type` to `path`. Returns 0 on success.
+static inline int dataset_write(const char* path, const void* data, uint64_t count, uint32_t elem_type, uint64_t seed) {
+    size_t elem_size = dataset_elem_size(elem_type);
+    if (elem_size == 0 || !dataset_host_is_little_endian()) return -1;
+
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) return -1;
+
+    int ok = dataset_write_header(file, count, elem_type, seed) == 0 &&
+             fwrite(data, elem_size, count, file) == count;
+    return (fclose(file) == 0 && ok) ? 0 : -1;
+}
+
+static inline int dataset_validate(Dataset* ds) {
+    memcpy(&ds->header, ds->base, sizeof(DatasetHeader));
+    size_t elem_size = dataset_elem_size(ds->header.elem_type);
+    if (memcmp(ds->header.magic, DATASET_MAGIC, sizeof(ds->header.magic)) != 0 || elem_size == 0)
+        return -1;
+    if (ds->header.count > (ds->size - sizeof(DatasetHeader)) / elem_size)
+        return -1;
+    ds->data = (const char*)ds->base + sizeof(DatasetHeader);
+    return 0;
+}
+
+// Maps the dataset at `path`. Returns 0 on success; release with dataset_close.
+static inline int dataset_open(const char* path, Dataset* ds) {
+    memset(ds, 0, sizeof(*ds));
+    if (!dataset_host_is_little_endian()) return -1;
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return -1;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(DatasetHeader)) {
+        close(fd);
+        return -1;
+    }
+    ds->size = (size_t)st.st_size;
+    void* base = mmap(NULL, ds->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return -1;
+    madvise(base, ds->size, MADV_SEQUENTIAL);
+    ds->base = base;
+#else
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size < (long)sizeof(DatasetHeader) || (ds->base = malloc(size)) == NULL) {
+        fclose(file);
+        return -1;
+    }
+    ds->size = (size_t)size;
+    size_t got = fread(ds->base, 1, ds->size, file);
+    fclose(file);
+    if (got != ds->size) {
+        free(ds->base);
+        ds->base = NULL;
+        return -1;
+    }
+#endif
+
+    if (dataset_validate(ds) != 0) {
+#ifndef _WIN32
+        munmap(ds->base, ds->size);
+#else
+        free(ds->base);
+#endif
+        ds->base = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+static inline void dataset_close(Dataset* ds) {
+    if (ds->base == NULL) return;
+#ifndef _WIN32
+    munmap(ds->base, ds->size);
+#else
+    free(ds->base);
+#endif
+    ds->base = NULL;
+    ds->data = NULL;
+}
+
+static inline const int32_t* dataset_int32(const Dataset* ds) {
+    return ds->header.elem_type == DATASET_INT32 ? (const int32_t*)ds->data : NULL;
+}
+
+// Converts a whitespace-separated text file of integers into a dataset.
+// Returns the number of values converted, or -1 on error.
+static inline long long dataset_convert_text(const char* text_path, const char* bin_path, uint32_t elem_type, uint64_t seed) {
+    FILE* in = fopen(text_path, "r");
+    if (in == NULL) return -1;
+
+    size_t elem_size = dataset_elem_size(elem_type);
+    size_t capacity = 1 << 16, count = 0;
+    char* values = (char*)malloc(capacity * elem_size);
+    long long value;
+    while (values != NULL && fscanf(in, "%lld", &value) == 1) {
+        if (count == capacity) {
+            capacity *= 2;
+            char* grown = (char*)realloc(values, capacity * elem_size);
+            if (grown == NULL) {
+                free(values);
+                values = NULL;
+                break;
+            }
+            values = grown;
+        }
+        if (elem_type == DATASET_INT32) {
+            int32_t v = (int32_t)value;
+            memcpy(values + count * elem_size, &v, elem_size);
+        } else {
+            int64_t v = (int64_t)value;
+            memcpy(values + count * elem_size, &v, elem_size);
+        }
+        count++;
+    }
+    fclose(in);
+    if (values == NULL || elem_size == 0) {
+        free(values);
+        return -1;
+    }
+
+    int rc = dataset_write(bin_path, values, count, elem_type, seed);
+    free(values);
+    return rc == 0 ? (long long)count : -1;
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dataset.h"
+#include "workload.h"
+
+// Writes a dataset straight from the workload generator, with no text file
+// in between. On POSIX systems the output file is mapped and filled in
+// place, so it can be larger than RAM (10^9 ints is 4 GB).
+//
+// Usage: generate_dataset <distribution> <count> <output.bin> [seed] [threads] [param]
+//   distribution: uniform, sorted, reversed, nearly-sorted, few-unique,
+//                 organ-pipe, sawtooth, zipf
+//   values are in [0, 1000000), like the random_numbers files of exp1b/exp2a
+//
+// Build: gcc -O2 generate_dataset.c -o generate_dataset -lm -pthread
+int main(int argc, char* argv[]) {
+    if (argc < 4 || workload_parse(argv[1]) < 0) {
+        printf("Usage: %s <distribution> <count> <output.bin> [seed] [threads] [param]\n", argv[0]);
+        printf("Distributions:");
+        for (int d = 0; d < WORKLOAD_NUM_DISTRIBUTIONS; d++) printf(" %s", workload_names[d]);
+        printf("\n");
+        return 1;
+    }
+
+    WorkloadSpec spec = {(WorkloadDistribution)workload_parse(argv[1]), 0, strtoll(argv[2], NULL, 10), 0, 1000000, 0};
+    spec.seed = (argc > 4) ? strtoull(argv[4], NULL, 10) : 1;
+    int threads = (argc > 5) ? atoi(argv[5]) : 1;
+    if (argc > 6) spec.param = strtoll(argv[6], NULL, 10);
+    if (spec.n < 0) {
+        printf("Count must not be negative!\n");
+        return 1;
+    }
+
+#ifndef _WIN32
+    FILE* file = fopen(argv[3], "wb+");
+    if (file == NULL || dataset_write_header(file, spec.n, DATASET_INT32, spec.seed) != 0) {
+        printf("Error opening %s!\n", argv[3]);
+        return 1;
+    }
+    fflush(file);
+    size_t size = sizeof(DatasetHeader) + (size_t)spec.n * sizeof(int32_t);
+    if (ftruncate(fileno(file), size) != 0) {
+        printf("Error resizing %s!\n", argv[3]);
+        fclose(file);
+        return 1;
+    }
+    char* base = (char*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileno(file), 0);
+    if (base == MAP_FAILED) {
+        printf("Error mapping %s!\n", argv[3]);
+        fclose(file);
+        return 1;
+    }
+    workload_fill(&spec, (int32_t*)(base + sizeof(DatasetHeader)), threads);
+    munmap(base, size);
+    fclose(file);
+#else
+    int32_t* values = (int32_t*)malloc((size_t)spec.n * sizeof(int32_t) + 1);
+    if (values == NULL) {
+        printf("Memory allocation failed!\n");
+        return 1;
+    }
+    workload_fill(&spec, values, threads);
+    if (dataset_write(argv[3], values, spec.n, DATASET_INT32, spec.seed) != 0) {
+        printf("Error writing %s!\n", argv[3]);
+        free(values);
+        return 1;
+    }
+    free(values);
+#endif
+
+    printf("Wrote %lld %s values (seed %llu) to %s\n", (long long)spec.n, workload_names[spec.dist],
+           (unsigned long long)spec.seed, argv[3]);
+    return 0;
+}
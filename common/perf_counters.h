@@ -0,0 +1,137 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+// Hardware performance counters around a timed region, via Linux
+// perf_event_open. Each counter is opened on its own so that a counter the
+// CPU or kernel does not offer (common in VMs and containers, or with
+// kernel.perf_event_paranoid > 2) only loses that column. Unavailable
+// counters read as -1 and are written to CSV files as NA.
+//
+// Counters follow the calling thread only; work done by other threads
+// (e.g. the parallel sort pool) is not included.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_BRANCH_MISSES,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_NUM_COUNTERS
+};
+
+static const char* const perf_counter_names[PERF_NUM_COUNTERS] = {
+    "Cycles", "Instructions", "Branch Misses", "L1D Misses", "LLC Misses"
+};
+
+typedef struct {
+    int fd[PERF_NUM_COUNTERS]; // -1 where the counter could not be opened
+    int available;             // number of counters that opened
+} PerfCounters;
+
+typedef struct {
+    long long value[PERF_NUM_COUNTERS]; // -1 where unavailable
+} PerfSample;
+
+static inline void perf_sample_clear(PerfSample* sample) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) sample->value[i] = -1;
+}
+
+#ifdef __linux__
+static inline int perf_counter_open_one(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+#endif
+
+// Returns the number of counters that could be opened (0 if none).
+static inline int perf_counters_open(PerfCounters* pc) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) pc->fd[i] = -1;
+    pc->available = 0;
+#ifdef __linux__
+    const uint64_t cache_miss = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+    pc->fd[PERF_CYCLES] = perf_counter_open_one(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    pc->fd[PERF_INSTRUCTIONS] = perf_counter_open_one(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    pc->fd[PERF_BRANCH_MISSES] = perf_counter_open_one(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    pc->fd[PERF_L1D_MISSES] = perf_counter_open_one(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cache_miss);
+    pc->fd[PERF_LLC_MISSES] = perf_counter_open_one(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | cache_miss);
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (pc->fd[i] >= 0) pc->available++;
+        else pc->fd[i] = -1;
+    }
+#endif
+    return pc->available;
+}
+
+static inline void perf_counters_close(PerfCounters* pc) {
+#ifdef __linux__
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (pc->fd[i] >= 0) close(pc->fd[i]);
+        pc->fd[i] = -1;
+    }
+#endif
+    pc->available = 0;
+}
+
+static inline void perf_counters_start(PerfCounters* pc) {
+#ifdef __linux__
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (pc->fd[i] < 0) continue;
+        ioctl(pc->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)pc;
+#endif
+}
+
+// Stops the counters and stores their values, scaled up if the kernel had
+// to multiplex them.
+static inline void perf_counters_stop(PerfCounters* pc, PerfSample* sample) {
+    perf_sample_clear(sample);
+#ifdef __linux__
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (pc->fd[i] >= 0) ioctl(pc->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        uint64_t data[3]; // value, time enabled, time running
+        if (pc->fd[i] < 0 || read(pc->fd[i], data, sizeof(data)) != (ssize_t)sizeof(data)) continue;
+        if (data[2] == 0) continue;
+        double scale = (data[2] < data[1]) ? (double)data[1] / (double)data[2] : 1.0;
+        sample->value[i] = (long long)((double)data[0] * scale);
+    }
+#else
+    (void)pc;
+#endif
+}
+
+static inline void perf_csv_header(FILE* file, const char* name) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) fprintf(file, ",%s %s", name, perf_counter_names[i]);
+}
+
+static inline void perf_csv_sample(FILE* file, const PerfSample* sample) {
+    for (int i = 0; i < PERF_NUM_COUNTERS; i++) {
+        if (sample->value[i] < 0) fprintf(file, ",NA");
+        else fprintf(file, ",%lld", sample->value[i]);
+    }
+}
+
+#endif
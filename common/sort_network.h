@@ -0,0 +1,238 @@
+#ifndef SORT_NETWORK_H
+#define SORT_NETWORK_H
+
+// Branchless SIMD kernels shared by the sorting code (exp2a, lab_ese):
+// network_sort() for the base case of the recursive sorts and
+// network_merge() for the merge step of every merge sort. C++ only.
+//
+// The lanes of a SIMD register are compared with min/max instead of
+// branches. The instruction set is picked at compile time: with -mavx2 (or
+// -march=native) 8 ints are handled per instruction, with -msse4.1 4, and
+// otherwise the same networks run on scalars, which compilers turn into
+// conditional moves.
+
+#include <algorithm>
+#include <climits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+#define NETWORK_MAX 64 // largest run network_sort handles
+
+#if defined(__AVX2__)
+#define NETWORK_ISA "avx2"
+struct NetworkLanes {
+    typedef __m256i reg;
+    static const int width = 8;
+
+    static reg load(const int* p) { return _mm256_loadu_si256((const __m256i*)p); }
+    static void store(int* p, reg v) { _mm256_storeu_si256((__m256i*)p, v); }
+    static reg lo(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    static reg hi(reg a, reg b) { return _mm256_max_epi32(a, b); }
+    static reg reverse(reg v) { return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)); }
+
+    static reg has_bit(reg x, int bit) {
+        return _mm256_cmpeq_epi32(_mm256_and_si256(x, _mm256_set1_epi32(bit)), _mm256_set1_epi32(bit));
+    }
+
+    // Compare-exchanges lane p with lane p ^ j. Lane p keeps the larger value
+    // when bit j of p differs from bit k of its element index base + p.
+    static reg exchange(reg v, int j, int k, int base) {
+        const reg lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        reg partner = _mm256_permutevar8x32_epi32(v, _mm256_xor_si256(lane, _mm256_set1_epi32(j)));
+        reg take_max = _mm256_xor_si256(has_bit(lane, j), has_bit(_mm256_add_epi32(lane, _mm256_set1_epi32(base)), k));
+        return _mm256_blendv_epi8(lo(v, partner), hi(v, partner), take_max);
+    }
+};
+#elif defined(__SSE4_1__)
+#define NETWORK_ISA "sse4.1"
+struct NetworkLanes {
+    typedef __m128i reg;
+    static const int width = 4;
+
+    static reg load(const int* p) { return _mm_loadu_si128((const __m128i*)p); }
+    static void store(int* p, reg v) { _mm_storeu_si128((__m128i*)p, v); }
+    static reg lo(reg a, reg b) { return _mm_min_epi32(a, b); }
+    static reg hi(reg a, reg b) { return _mm_max_epi32(a, b); }
+    static reg reverse(reg v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+
+    static reg has_bit(reg x, int bit) {
+        return _mm_cmpeq_epi32(_mm_and_si128(x, _mm_set1_epi32(bit)), _mm_set1_epi32(bit));
+    }
+
+    static reg exchange(reg v, int j, int k, int base) {
+        const reg lane = _mm_setr_epi32(0, 1, 2, 3);
+        reg partner = (j == 1) ? _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)) : _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        reg take_max = _mm_xor_si128(has_bit(lane, j), has_bit(_mm_add_epi32(lane, _mm_set1_epi32(base)), k));
+        return _mm_blendv_epi8(lo(v, partner), hi(v, partner), take_max);
+    }
+};
+#else
+#define NETWORK_ISA "scalar"
+struct NetworkLanes {
+    typedef int reg;
+    static const int width = 1;
+
+    static reg load(const int* p) { return *p; }
+    static void store(int* p, reg v) { *p = v; }
+    static reg lo(reg a, reg b) { return a < b ? a : b; }
+    static reg hi(reg a, reg b) { return a < b ? b : a; }
+    static reg reverse(reg v) { return v; }
+    static reg exchange(reg v, int, int, int) { return v; } // one lane, nothing to exchange
+};
+#endif
+
+// Sorts arr[0..n) for n <= NETWORK_MAX with a bitonic network over 8, 16,
+// 32 or 64 elements, padding with INT_MAX. Element i lives in lane
+// i % width of register i / width, so compare distances of at least a
+// register width become min/max between whole registers and shorter ones
+// become exchanges inside a register.
+inline void network_sort(int* arr, int n) {
+    typedef NetworkLanes::reg reg;
+    const int width = NetworkLanes::width;
+    int size = 8;
+    while (size < n) size *= 2;
+
+    int buffer[NETWORK_MAX];
+    std::copy(arr, arr + n, buffer);
+    std::fill(buffer + n, buffer + size, INT_MAX);
+    reg v[NETWORK_MAX / width];
+    int regs = size / width;
+    for (int r = 0; r < regs; r++) v[r] = NetworkLanes::load(buffer + r * width);
+
+    for (int k = 2; k <= size; k *= 2) {
+        for (int j = k / 2; j > 0; j /= 2) {
+            if (j >= width) {
+                for (int r = 0; r < regs; r++) {
+                    int l = r ^ (j / width);
+                    if (l < r) continue;
+                    reg a = NetworkLanes::lo(v[r], v[l]), b = NetworkLanes::hi(v[r], v[l]);
+                    bool ascending = ((r * width) & k) == 0;
+                    v[r] = ascending ? a : b;
+                    v[l] = ascending ? b : a;
+                }
+            } else {
+                for (int r = 0; r < regs; r++) v[r] = NetworkLanes::exchange(v[r], j, k, r * width);
+            }
+        }
+    }
+
+    for (int r = 0; r < regs; r++) NetworkLanes::store(buffer + r * width, v[r]);
+    std::copy(buffer, buffer + n, arr);
+}
+
+// Element-at-a-time merge of sorted a[0..na) and b[0..nb) into out, with
+// the comparison feeding conditional moves instead of a branch.
+inline void branchless_merge(const int* a, int na, const int* b, int nb, int* out) {
+    const int* a_end = a + na;
+    const int* b_end = b + nb;
+    while (a < a_end && b < b_end) {
+        bool take_b = *b < *a;
+        *out++ = take_b ? *b : *a;
+        b += take_b;
+        a += !take_b;
+    }
+    out = std::copy(a, a_end, out);
+    std::copy(b, b_end, out);
+}
+
+// Sorts a bitonic block of 8 elements held in 8 / width registers.
+inline void network_bitonic_merge8(NetworkLanes::reg* v) {
+    const int width = NetworkLanes::width, regs = 8 / width;
+    for (int j = 4; j > 0; j /= 2) {
+        if (j >= width) {
+            for (int r = 0; r < regs; r++) {
+                int l = r ^ (j / width);
+                if (l < r) continue;
+                NetworkLanes::reg a = NetworkLanes::lo(v[r], v[l]);
+                v[l] = NetworkLanes::hi(v[r], v[l]);
+                v[r] = a;
+            }
+        } else {
+            for (int r = 0; r < regs; r++) v[r] = NetworkLanes::exchange(v[r], j, 8, r * width);
+        }
+    }
+}
+
+// Merges the sorted 8-element blocks x and y so that x ends up with the 8
+// smallest and y with the 8 largest, both sorted: min/max of x against y
+// reversed splits them into two bitonic halves, which are then sorted.
+inline void network_merge_blocks(NetworkLanes::reg* x, NetworkLanes::reg* y) {
+    const int regs = 8 / NetworkLanes::width;
+    NetworkLanes::reg reversed[8];
+    for (int r = 0; r < regs; r++) reversed[r] = NetworkLanes::reverse(y[regs - 1 - r]);
+    for (int r = 0; r < regs; r++) {
+        NetworkLanes::reg a = x[r];
+        x[r] = NetworkLanes::lo(a, reversed[r]);
+        y[r] = NetworkLanes::hi(a, reversed[r]);
+    }
+    network_bitonic_merge8(x);
+    network_bitonic_merge8(y);
+}
+
+// Merges sorted a[0..na) and b[0..nb) into out (which must not overlap
+// them) 8 elements per step. y carries the 8 largest elements seen so far;
+// x is refilled from whichever run has the smaller next element, merged
+// against y, and its lower half is final. When that run has fewer than 8
+// elements left, y and its remainder are merged into a short buffer that
+// takes its place; the last few elements are merged by branchless_merge.
+// Without SIMD lanes the whole merge is branchless_merge. Runs that do not
+// overlap at all (sorted or reversed input) are just concatenated.
+inline void network_merge(const int* a, int na, const int* b, int nb, int* out) {
+    typedef NetworkLanes::reg reg;
+    const int width = NetworkLanes::width, regs = 8 / width;
+    if (na == 0 || nb == 0 || a[na - 1] <= b[0]) {
+        std::copy(b, b + nb, std::copy(a, a + na, out));
+        return;
+    }
+    if (b[nb - 1] < a[0]) {
+        std::copy(a, a + na, std::copy(b, b + nb, out));
+        return;
+    }
+    if (width == 1) {
+        branchless_merge(a, na, b, nb, out);
+        return;
+    }
+
+    int pending[8], tails[2][16], which = 0;
+    while (na >= 8 && nb >= 8) {
+        reg x[8], y[8];
+        for (int r = 0; r < regs; r++) {
+            x[r] = NetworkLanes::load(a + r * width);
+            y[r] = NetworkLanes::load(b + r * width);
+        }
+        a += 8, na -= 8, b += 8, nb -= 8;
+
+        bool from_a;
+        for (;;) {
+            network_merge_blocks(x, y);
+            for (int r = 0; r < regs; r++) NetworkLanes::store(out + r * width, x[r]);
+            out += 8;
+            from_a = nb == 0 || (na > 0 && *a <= *b);
+            if ((from_a ? na : nb) < 8) break;
+            const int*& run = from_a ? a : b;
+            for (int r = 0; r < regs; r++) x[r] = NetworkLanes::load(run + r * width);
+            run += 8;
+            (from_a ? na : nb) -= 8;
+        }
+
+        for (int r = 0; r < regs; r++) NetworkLanes::store(pending + r * width, y[r]);
+        const int* short_run = from_a ? a : b;
+        const int* long_run = from_a ? b : a;
+        int short_n = from_a ? na : nb, long_n = from_a ? nb : na;
+        int* tail = tails[which];
+        which ^= 1;
+        if (long_n < 16) {
+            branchless_merge(pending, 8, short_run, short_n, tail);
+            branchless_merge(tail, 8 + short_n, long_run, long_n, out);
+            return;
+        }
+        branchless_merge(pending, 8, short_run, short_n, tail);
+        a = tail, na = 8 + short_n;
+        b = long_run, nb = long_n;
+    }
+    branchless_merge(a, na, b, nb, out);
+}
+
+#endif
@@ -0,0 +1,156 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+// Fork/join thread pool shared by the parallel drivers (exp2a sorts, exp2b
+// hulls). C++ only; build with -pthread.
+//
+// Every worker owns a deque: it pushes/pops its own tasks at the back and
+// steals from the front of the others. A thread that forks a task and then
+// has to wait for it keeps executing other tasks instead of blocking, so
+// nested fork/join never deadlocks even with a single worker.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+    struct Task {
+        std::function<void()> fn;
+        std::atomic<bool> done{false};
+    };
+    struct Queue {
+        std::mutex m;
+        std::deque<Task*> q;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<Queue>> queues; // queues[0] belongs to external callers
+    std::atomic<int> pending{0};
+    std::atomic<bool> stop{false};
+    std::mutex sleep_m;
+    std::condition_variable sleep_cv;
+
+    // The pool a thread works for and its queue in it. A thread that is not
+    // one of this pool's workers (including a worker of another pool) is an
+    // external caller and uses queue 0.
+    struct Membership {
+        const WorkStealingPool* pool;
+        int id;
+    };
+
+    static Membership& membership() {
+        static thread_local Membership m = {nullptr, 0};
+        return m;
+    }
+
+    int worker_id() const {
+        const Membership& m = membership();
+        return m.pool == this ? m.id : 0;
+    }
+
+    void push(Task* t) {
+        Queue& own = *queues[worker_id()];
+        {
+            std::lock_guard<std::mutex> lock(own.m);
+            own.q.push_back(t);
+        }
+        pending++;
+        sleep_cv.notify_one();
+    }
+
+    Task* pop_own() {
+        Queue& own = *queues[worker_id()];
+        std::lock_guard<std::mutex> lock(own.m);
+        if (own.q.empty()) return nullptr;
+        Task* t = own.q.back();
+        own.q.pop_back();
+        pending--;
+        return t;
+    }
+
+    Task* steal() {
+        int n = queues.size();
+        int start = worker_id();
+        for (int k = 1; k <= n; k++) {
+            Queue& victim = *queues[(start + k) % n];
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (!victim.q.empty()) {
+                Task* t = victim.q.front();
+                victim.q.pop_front();
+                pending--;
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    bool run_one() {
+        Task* t = pop_own();
+        if (!t) t = steal();
+        if (!t) return false;
+        t->fn();
+        t->done.store(true, std::memory_order_release);
+        return true;
+    }
+
+    void worker_loop(int id) {
+        membership() = {this, id};
+        while (!stop.load()) {
+            if (run_one()) continue;
+            std::unique_lock<std::mutex> lock(sleep_m);
+            sleep_cv.wait_for(lock, std::chrono::milliseconds(1), [this] { return stop.load() || pending.load() > 0; });
+        }
+    }
+
+public:
+    explicit WorkStealingPool(unsigned num_threads) {
+        if (num_threads == 0) num_threads = 1;
+        // The calling thread takes part in every fork/join, so it counts as one thread.
+        for (unsigned i = 0; i < num_threads; i++)
+            queues.push_back(std::make_unique<Queue>());
+        for (unsigned i = 1; i < num_threads; i++)
+            workers.emplace_back(&WorkStealingPool::worker_loop, this, (int)i);
+    }
+
+    ~WorkStealingPool() {
+        stop = true;
+        sleep_cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    unsigned size() const { return queues.size(); }
+
+    // Runs f and g, possibly in parallel, and returns once both have finished.
+    template<typename F, typename G>
+    void fork_join(F&& f, G&& g) {
+        Task task;
+        task.fn = g;
+        push(&task);
+        f();
+        while (!task.done.load(std::memory_order_acquire)) {
+            if (!run_one()) std::this_thread::yield();
+        }
+    }
+};
+
+// Runs f(i) for every i in [lo, hi) as tasks on the pool.
+template<typename F>
+void parallel_for(WorkStealingPool& pool, int lo, int hi, const F& f) {
+    if (hi - lo <= 0) return;
+    if (hi - lo == 1) {
+        f(lo);
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    pool.fork_join(
+        [&] { parallel_for(pool, lo, mid, f); },
+        [&] { parallel_for(pool, mid, hi, f); });
+}
+
+#endif
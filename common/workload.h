@@ -0,0 +1,223 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+// Reproducible benchmark inputs shared by the sorting (exp1b, exp2a) and
+// max-subarray (exp2c) drivers.
+//
+// Every value is a pure function of (distribution, seed, index): the PRNG
+// is counter-based (SplitMix64 applied to seed + index), so any thread can
+// generate any slice of the array on its own and the result does not depend
+// on how the work was split. workload_fill() splits the array across
+// threads; workload_fill_range() generates one slice.
+//
+// Values lie in [min_value, min_value + range). C drivers need -lm (Zipf
+// uses pow) and, on older glibc, -pthread.
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+typedef enum {
+    WORKLOAD_UNIFORM,       // independent uniform values
+    WORKLOAD_SORTED,        // non-decreasing ramp over the range
+    WORKLOAD_REVERSED,      // non-increasing ramp over the range
+    WORKLOAD_NEARLY_SORTED, // sorted ramp with `param` random swaps (default n/100)
+    WORKLOAD_FEW_UNIQUE,    // uniform over `param` distinct values (default 16)
+    WORKLOAD_ORGAN_PIPE,    // ramps up to the middle, then back down
+    WORKLOAD_SAWTOOTH,      // ascending ramps of length `param` (default sqrt(n))
+    WORKLOAD_ZIPF,          // Zipf-like ranks with exponent `param` / 100 (default 1.0)
+    WORKLOAD_NUM_DISTRIBUTIONS
+} WorkloadDistribution;
+
+static const char* const workload_names[WORKLOAD_NUM_DISTRIBUTIONS] = {
+    "uniform", "sorted", "reversed", "nearly-sorted", "few-unique", "organ-pipe", "sawtooth", "zipf"
+};
+
+typedef struct {
+    WorkloadDistribution dist;
+    uint64_t seed;
+    int64_t n;         // total number of elements
+    int64_t min_value;
+    int64_t range;     // values lie in [min_value, min_value + range)
+    int64_t param;     // distribution parameter, 0 for the default
+} WorkloadSpec;
+
+static inline uint64_t workload_mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// The i-th random word of stream `stream` under `seed`.
+static inline uint64_t workload_random(uint64_t seed, uint64_t stream, uint64_t i) {
+    return workload_mix(workload_mix(seed ^ (stream * 0xD1B54A32D192ED03ULL)) + i);
+}
+
+// Uniform in [0, bound) without the bias of %.
+static inline uint64_t workload_below(uint64_t r, uint64_t bound) {
+#ifdef __SIZEOF_INT128__
+    return (uint64_t)(((unsigned __int128)r * bound) >> 64);
+#else
+    return r % bound;
+#endif
+}
+
+static inline double workload_unit(uint64_t r) {
+    return (double)(r >> 11) * (1.0 / 9007199254740992.0); // [0, 1)
+}
+
+static inline int64_t workload_ramp(const WorkloadSpec* spec, int64_t pos, int64_t len) {
+    return len <= 1 ? 0 : (int64_t)((double)pos * (double)(spec->range - 1) / (double)(len - 1));
+}
+
+// Returns -1 if `name` is not a known distribution.
+static inline int workload_parse(const char* name) {
+    for (int d = 0; d < WORKLOAD_NUM_DISTRIBUTIONS; d++)
+        if (strcmp(name, workload_names[d]) == 0) return d;
+    return -1;
+}
+
+static inline int64_t workload_value(const WorkloadSpec* spec, int64_t i) {
+    uint64_t r = workload_random(spec->seed, 0, (uint64_t)i);
+    int64_t n = spec->n, v = 0;
+    switch (spec->dist) {
+    case WORKLOAD_UNIFORM:
+        v = (int64_t)workload_below(r, (uint64_t)spec->range);
+        break;
+    case WORKLOAD_SORTED:
+    case WORKLOAD_NEARLY_SORTED:
+        v = workload_ramp(spec, i, n);
+        break;
+    case WORKLOAD_REVERSED:
+        v = workload_ramp(spec, n - 1 - i, n);
+        break;
+    case WORKLOAD_FEW_UNIQUE: {
+        int64_t unique = spec->param > 0 ? spec->param : 16;
+        v = workload_ramp(spec, (int64_t)workload_below(r, (uint64_t)unique), unique);
+        break;
+    }
+    case WORKLOAD_ORGAN_PIPE: {
+        int64_t half = (n + 1) / 2;
+        v = workload_ramp(spec, i < half ? i : n - 1 - i, half);
+        break;
+    }
+    case WORKLOAD_SAWTOOTH: {
+        int64_t period = spec->param > 0 ? spec->param : (int64_t)sqrt((double)n) + 1;
+        v = workload_ramp(spec, i % period, period);
+        break;
+    }
+    case WORKLOAD_ZIPF: {
+        // Inverse CDF of a power law on [1, range + 1): rank k has
+        // probability ~ k^-s, so small ranks dominate.
+        double s = spec->param > 0 ? spec->param / 100.0 : 1.0;
+        double u = workload_unit(r), top = (double)spec->range + 1;
+        double x = (fabs(s - 1.0) < 1e-9) ? pow(top, u) : pow((pow(top, 1 - s) - 1) * u + 1, 1 / (1 - s));
+        v = (int64_t)x - 1;
+        if (v >= spec->range) v = spec->range - 1;
+        if (v < 0) v = 0;
+        break;
+    }
+    default:
+        break;
+    }
+    return spec->min_value + v;
+}
+
+// Generates elements [begin, end) of the array into out[0 .. end-begin).
+static inline void workload_fill_range(const WorkloadSpec* spec, int32_t* out, int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) out[i - begin] = (int32_t)workload_value(spec, i);
+}
+
+// Applies the random swaps of WORKLOAD_NEARLY_SORTED. They depend on each
+// other, so this one serial O(k) pass runs after all slices are filled.
+static inline void workload_finish(const WorkloadSpec* spec, int32_t* out) {
+    if (spec->dist != WORKLOAD_NEARLY_SORTED || spec->n < 2) return;
+    int64_t swaps = spec->param > 0 ? spec->param : spec->n / 100;
+    for (int64_t k = 0; k < swaps; k++) {
+        uint64_t a = workload_below(workload_random(spec->seed, 1, 2 * k), spec->n);
+        uint64_t b = workload_below(workload_random(spec->seed, 1, 2 * k + 1), spec->n);
+        int32_t t = out[a];
+        out[a] = out[b];
+        out[b] = t;
+    }
+}
+
+typedef struct {
+    const WorkloadSpec* spec;
+    int32_t* out; // receives element `begin`
+    int64_t begin, end;
+} WorkloadSlice;
+
+static inline void* workload_fill_slice(void* arg) {
+    WorkloadSlice* slice = (WorkloadSlice*)arg;
+    workload_fill_range(slice->spec, slice->out, slice->begin, slice->end);
+    return NULL;
+}
+
+// Generates elements [begin, end) into out[0 .. end-begin) using up to
+// `threads` threads; the nearly-sorted swaps are not applied.
+static inline void workload_fill_range_parallel(const WorkloadSpec* spec, int32_t* out, int64_t begin, int64_t end, int threads) {
+    int64_t len = end - begin;
+    if (threads < 1 || len < 65536) threads = 1;
+#ifndef _WIN32
+    if (threads > 1) {
+        pthread_t* ids = (pthread_t*)malloc(threads * sizeof(pthread_t));
+        WorkloadSlice* slices = (WorkloadSlice*)malloc(threads * sizeof(WorkloadSlice));
+        if (ids != NULL && slices != NULL) {
+            int started = 0;
+            for (int t = 0; t < threads; t++) {
+                slices[t].spec = spec;
+                slices[t].begin = begin + len * t / threads;
+                slices[t].end = begin + len * (t + 1) / threads;
+                slices[t].out = out + (slices[t].begin - begin);
+                if (pthread_create(&ids[started], NULL, workload_fill_slice, &slices[t]) == 0) started++;
+                else workload_fill_slice(&slices[t]);
+            }
+            for (int t = 0; t < started; t++) pthread_join(ids[t], NULL);
+            free(ids);
+            free(slices);
+            return;
+        }
+        free(ids);
+        free(slices);
+    }
+#endif
+    workload_fill_range(spec, out, begin, end);
+}
+
+static inline int workload_default_threads(void) {
+#if !defined(_WIN32) && defined(_SC_NPROCESSORS_ONLN)
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+#else
+    return 1;
+#endif
+}
+
+// Fills out[0 .. spec->n) using up to `threads` threads.
+static inline void workload_fill(const WorkloadSpec* spec, int32_t* out, int threads) {
+    workload_fill_range_parallel(spec, out, 0, spec->n, threads);
+    workload_finish(spec, out);
+}
+
+// Distribution and seed from WORKLOAD_DIST / WORKLOAD_SEED / WORKLOAD_PARAM,
+// falling back to `dist` and `seed`.
+static inline WorkloadSpec workload_from_env(WorkloadDistribution dist, uint64_t seed, int64_t n, int64_t min_value, int64_t range) {
+    WorkloadSpec spec = {dist, seed, n, min_value, range, 0};
+    const char* name = getenv("WORKLOAD_DIST");
+    const char* seed_env = getenv("WORKLOAD_SEED");
+    const char* param = getenv("WORKLOAD_PARAM");
+    if (name != NULL && workload_parse(name) >= 0) spec.dist = (WorkloadDistribution)workload_parse(name);
+    if (seed_env != NULL) spec.seed = strtoull(seed_env, NULL, 10);
+    if (param != NULL) spec.param = strtoll(param, NULL, 10);
+    return spec;
+}
+
+#endif
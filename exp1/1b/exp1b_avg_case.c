@@ -1,34 +1,50 @@
+// Build: gcc exp1b_avg_case.c -lm
+#define _GNU_SOURCE // CPU pinning in bench_timer.h
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
-#define DATA_FILE "random_numbers.txt"
+#include "../../common/bench_timer.h"
+#include "../../common/dataset.h"
+#include "../../common/workload.h"
+
+#define DATA_FILE "random_numbers.bin"
 #define TIME_FILE "sorting_times.csv"
+#define INCREMENTAL_TIME_FILE "sorting_times_incremental.csv"
 #define NUM_COUNT 100000
 
-void generateRandomNumbers() {
-  FILE *outFile = fopen(DATA_FILE, "w");
-  if (outFile == NULL) {
-    printf("Error opening file!\n");
+// Uniform numbers below 1,000,000 unless WORKLOAD_DIST / WORKLOAD_SEED say
+// otherwise (see common/workload.h)
+void generateRandomNumbers(int count) {
+  int *numbers = (int *)malloc(count * sizeof(int));
+  if (numbers == NULL) {
+    printf("Memory allocation failed!\n");
     return;
   }
-  srand(time(0));
-  for (int i = 0; i < NUM_COUNT; i++) {
-    fprintf(outFile, "%d ", rand() % 1000000);
+  WorkloadSpec spec =
+      workload_from_env(WORKLOAD_UNIFORM, time(0), count, 0, 1000000);
+  workload_fill(&spec, numbers, workload_default_threads());
+  if (dataset_write(DATA_FILE, numbers, count, DATASET_INT32, spec.seed) !=
+      0) {
+    printf("Error opening file!\n");
   }
-  fclose(outFile);
+  free(numbers);
 }
 
-void readNumbers(int *numbers, int count) {
-  FILE *inFile = fopen(DATA_FILE, "r");
-  if (inFile == NULL) {
+// Maps the dataset written by generateRandomNumbers; the numbers are then
+// sliced straight out of the mapping for every block size.
+const int *openNumbers(Dataset *dataset, int count) {
+  if (dataset_open(DATA_FILE, dataset) != 0) {
     printf("Error opening file!\n");
-    return;
+    return NULL;
   }
-  for (int i = 0; i < count; i++) {
-    fscanf(inFile, "%d", &numbers[i]);
+  if (dataset_int32(dataset) == NULL || dataset->header.count < (uint64_t)count) {
+    printf("Unexpected dataset in %s!\n", DATA_FILE);
+    dataset_close(dataset);
+    return NULL;
   }
-  fclose(inFile);
+  return dataset_int32(dataset);
 }
 
 void insertionSort(int *arr, int n) {
@@ -43,6 +59,25 @@ void insertionSort(int *arr, int n) {
   }
 }
 
+// Extends the sorted prefix arr[0..sorted-1] to arr[0..n-1]: each new
+// element's slot is found by binary search and the tail is shifted with
+// one memmove instead of element by element.
+void binaryInsertionExtend(int *arr, int sorted, int n) {
+  for (int i = sorted; i < n; i++) {
+    int key = arr[i];
+    int lo = 0, hi = i;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (arr[mid] <= key)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    memmove(&arr[lo + 1], &arr[lo], (i - lo) * sizeof(int));
+    arr[lo] = key;
+  }
+}
+
 void selectionSort(int *arr, int n) {
   for (int i = 0; i < n - 1; i++) {
     int minIndex = i;
@@ -57,61 +92,151 @@ void selectionSort(int *arr, int n) {
   }
 }
 
+// One timed sort for bench_measure: prepareSortRun refills `work` from
+// `source` outside the timed region, runSortRun sorts it.
+typedef struct {
+  const int *source;
+  int *work;
+  int n;
+  void (*sort)(int *, int);
+} SortRun;
+
+void prepareSortRun(void *ctx) {
+  SortRun *run = (SortRun *)ctx;
+  memcpy(run->work, run->source, run->n * sizeof(int));
+}
+
+void runSortRun(void *ctx) {
+  SortRun *run = (SortRun *)ctx;
+  run->sort(run->work, run->n);
+}
+
 void measureSortingTime() {
   FILE *timeFile = fopen(TIME_FILE, "w");
   if (timeFile == NULL) {
     printf("Error opening file!\n");
     return;
   }
-  fprintf(timeFile,
-          "Block Size,Insertion Sort Time (ms),Selection Sort Time (ms)\n");
-
-  int *numbers = (int *)malloc(NUM_COUNT * sizeof(int));
-  if (numbers == NULL) {
-    printf("Memory allocation failed!\n");
+  fprintf(timeFile, "Block Size");
+  bench_csv_header(timeFile, "Insertion Sort");
+  perf_csv_header(timeFile, "Insertion Sort");
+  bench_csv_header(timeFile, "Selection Sort");
+  perf_csv_header(timeFile, "Selection Sort");
+  fprintf(timeFile, "\n");
+
+  Dataset dataset;
+  const int *numbers = openNumbers(&dataset, NUM_COUNT);
+  int *work = (int *)malloc(NUM_COUNT * sizeof(int));
+  if (numbers == NULL || work == NULL) {
+    if (work == NULL)
+      printf("Memory allocation failed!\n");
+    free(work);
+    dataset_close(&dataset);
+    fclose(timeFile);
     return;
   }
-  readNumbers(numbers, NUM_COUNT);
+
+  BenchConfig config = bench_default_config();
+  if (bench_pin_to_cpu(0) != 0)
+    printf("CPU pinning unavailable, timings may be noisier\n");
+  PerfCounters counters;
+  bench_enable_counters(&config, &counters);
 
   for (int blockSize = 100; blockSize <= NUM_COUNT; blockSize += 100) {
-    int *tempInsertion = (int *)malloc(blockSize * sizeof(int));
-    int *tempSelection = (int *)malloc(blockSize * sizeof(int));
-    if (tempInsertion == NULL || tempSelection == NULL) {
-      printf("Memory allocation failed!\n");
-      return;
-    }
+    SortRun insertion = {numbers, work, blockSize, insertionSort};
+    SortRun selection = {numbers, work, blockSize, selectionSort};
+    BenchStats insertionStats, selectionStats;
+    bench_measure(&config, prepareSortRun, runSortRun, &insertion,
+                  &insertionStats);
+    bench_measure(&config, prepareSortRun, runSortRun, &selection,
+                  &selectionStats);
+
+    fprintf(timeFile, "%d", blockSize);
+    bench_csv_stats(timeFile, &insertionStats);
+    perf_csv_sample(timeFile, &insertionStats.counters);
+    bench_csv_stats(timeFile, &selectionStats);
+    perf_csv_sample(timeFile, &selectionStats.counters);
+    fprintf(timeFile, "\n");
+    printf("Block Size: %d - Insertion: %.4f ms (p95 %.4f), Selection: %.4f "
+           "ms (p95 %.4f)\n",
+           blockSize, insertionStats.median_ms, insertionStats.p95_ms,
+           selectionStats.median_ms, selectionStats.p95_ms);
+  }
 
-    for (int i = 0; i < blockSize; i++) {
-      tempInsertion[i] = numbers[i];
-      tempSelection[i] = numbers[i];
-    }
+  perf_counters_close(&counters);
+  free(work);
+  fclose(timeFile);
+  dataset_close(&dataset);
+}
 
-    clock_t start = clock();
-    insertionSort(tempInsertion, blockSize);
-    clock_t stop = clock();
-    double insertionTime = (double)(stop - start) * 1000 /
-                           CLOCKS_PER_SEC; // Convert to milliseconds
+// Incremental sweep: the array stays sorted between block sizes, so block k
+// only inserts the 100 numbers that block k-1 did not have. Both the
+// marginal time of those insertions and the running total are recorded.
+void measureIncrementalSortingTime(int count) {
+  FILE *timeFile = fopen(INCREMENTAL_TIME_FILE, "w");
+  if (timeFile == NULL) {
+    printf("Error opening file!\n");
+    return;
+  }
+  fprintf(timeFile, "Block Size,Insertion Marginal (ms),Insertion "
+                    "Cumulative (ms)\n");
 
-    start = clock();
-    selectionSort(tempSelection, blockSize);
-    stop = clock();
-    double selectionTime = (double)(stop - start) * 1000 / CLOCKS_PER_SEC;
+  Dataset dataset;
+  const int *numbers = openNumbers(&dataset, count);
+  if (numbers == NULL) {
+    fclose(timeFile);
+    return;
+  }
 
-    fprintf(timeFile, "%d,%.2f,%.2f\n", blockSize, insertionTime,
-            selectionTime);
-    printf("Block Size: %d - Insertion: %.2f ms, Selection: %.2f ms\n",
-           blockSize, insertionTime, selectionTime);
+  int *sorted = (int *)malloc(count * sizeof(int));
+  if (sorted == NULL) {
+    printf("Memory allocation failed!\n");
+    fclose(timeFile);
+    dataset_close(&dataset);
+    return;
+  }
 
-    free(tempInsertion);
-    free(tempSelection);
+  double cumulativeTime = 0;
+  int prevSize = 0;
+  for (int blockSize = 100; blockSize <= count; blockSize += 100) {
+    memcpy(&sorted[prevSize], &numbers[prevSize],
+           (blockSize - prevSize) * sizeof(int));
+
+    double start = bench_now_ms();
+    binaryInsertionExtend(sorted, prevSize, blockSize);
+    double marginalTime = bench_now_ms() - start;
+    cumulativeTime += marginalTime;
+    prevSize = blockSize;
+
+    fprintf(timeFile, "%d,%.6f,%.6f\n", blockSize, marginalTime,
+            cumulativeTime);
+    if (blockSize % 10000 == 0) {
+      printf("Block Size: %d - Marginal: %.2f ms, Cumulative: %.2f ms\n",
+             blockSize, marginalTime, cumulativeTime);
+    }
   }
 
+  free(sorted);
   fclose(timeFile);
-  free(numbers);
+  dataset_close(&dataset);
 }
 
-int main() {
-  generateRandomNumbers();
+// Usage: ./a.out                       full re-sort sweep over NUM_COUNT
+//        ./a.out incremental [count]   incremental sweep up to count numbers
+int main(int argc, char *argv[]) {
+  if (argc > 1 && strcmp(argv[1], "incremental") == 0) {
+    int count = (argc > 2) ? atoi(argv[2]) : NUM_COUNT;
+    if (count < 100) {
+      printf("Count must be at least 100!\n");
+      return 1;
+    }
+    generateRandomNumbers(count);
+    measureIncrementalSortingTime(count);
+    printf("Sorting times stored in %s\n", INCREMENTAL_TIME_FILE);
+    return 0;
+  }
+
+  generateRandomNumbers(NUM_COUNT);
 
   measureSortingTime();
 
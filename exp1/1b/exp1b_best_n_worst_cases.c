@@ -1,40 +1,16 @@
+// Build: gcc exp1b_best_n_worst_cases.c -lm
+#define _GNU_SOURCE // CPU pinning in bench_timer.h
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
+#include <string.h>
+
+#include "../../common/bench_timer.h"
+#include "../../common/workload.h"
 
 // Constants
-#define DATA_FILE "random_nos.txt"
 #define TIME_FILE "times.csv"
 #define NUM_COUNT 100000
 
-// Function to generate and store random numbers
-void generateRandomNumbers() {
-  FILE *outFile = fopen(DATA_FILE, "w");
-  if (outFile == NULL) {
-    printf("Error opening file!\n");
-    return;
-  }
-  srand(time(0)); // Seed the random number generator
-  for (int i = 0; i < NUM_COUNT; i++) {
-    fprintf(outFile, "%d ",
-            rand() % 1000000); // Generate random numbers between 0 and 999999
-  }
-  fclose(outFile);
-}
-
-// Function to read numbers from file
-void readNumbers(int *numbers, int count) {
-  FILE *inFile = fopen(DATA_FILE, "r");
-  if (inFile == NULL) {
-    printf("Error opening file!\n");
-    return;
-  }
-  for (int i = 0; i < count; i++) {
-    fscanf(inFile, "%d", &numbers[i]); // Read numbers into an array
-  }
-  fclose(inFile);
-}
-
 // Insertion Sort Algorithm
 void insertionSort(int *arr, int n) {
   for (int i = 1; i < n; i++) {
@@ -66,24 +42,39 @@ void selectionSort(int *arr, int n) {
 
 // Function to generate best case for Insertion Sort (already sorted array)
 void generateBestCaseInsertion(int *arr, int n) {
-  for (int i = 0; i < n; i++) {
-    arr[i] = i;
-  }
+  WorkloadSpec spec = {WORKLOAD_SORTED, 0, n, 0, n, 0}; // 0, 1, ..., n-1
+  workload_fill(&spec, arr, 1);
 }
 
 // Function to generate worst case for Insertion Sort (reverse sorted array)
 void generateWorstCaseInsertion(int *arr, int n) {
-  for (int i = 0; i < n; i++) {
-    arr[i] = n - i;
-  }
+  WorkloadSpec spec = {WORKLOAD_REVERSED, 0, n, 1, n, 0}; // n, n-1, ..., 1
+  workload_fill(&spec, arr, 1);
 }
 
 // Function to generate worst case for Selection Sort (smallest element always
 // at the end)
 void generateWorstCaseSelection(int *arr, int n) {
-  for (int i = 0; i < n; i++) {
-    arr[i] = n - i;
-  }
+  generateWorstCaseInsertion(arr, n);
+}
+
+// One timed sort for bench_measure: prepareSortRun refills `work` from
+// `source` outside the timed region, runSortRun sorts it.
+typedef struct {
+  const int *source;
+  int *work;
+  int n;
+  void (*sort)(int *, int);
+} SortRun;
+
+void prepareSortRun(void *ctx) {
+  SortRun *run = (SortRun *)ctx;
+  memcpy(run->work, run->source, run->n * sizeof(int));
+}
+
+void runSortRun(void *ctx) {
+  SortRun *run = (SortRun *)ctx;
+  run->sort(run->work, run->n);
 }
 
 // Function to measure sorting time for best and worst cases
@@ -93,91 +84,78 @@ void measureSortingTime() {
     printf("Error opening file!\n");
     return;
   }
-  fprintf(
-      timeFile,
-      "Block Size,Insertion Sort Best Case (ms),Insertion Sort Worst Case "
-      "(ms),Selection Sort Best Case (ms),Selection Sort Worst Case (ms)\n");
-
-  int *numbers = (int *)malloc(NUM_COUNT * sizeof(int));
-  if (numbers == NULL) {
+  fprintf(timeFile, "Block Size");
+  bench_csv_header(timeFile, "Insertion Sort Best Case");
+  perf_csv_header(timeFile, "Insertion Sort Best Case");
+  bench_csv_header(timeFile, "Insertion Sort Worst Case");
+  perf_csv_header(timeFile, "Insertion Sort Worst Case");
+  bench_csv_header(timeFile, "Selection Sort Best Case");
+  perf_csv_header(timeFile, "Selection Sort Best Case");
+  bench_csv_header(timeFile, "Selection Sort Worst Case");
+  perf_csv_header(timeFile, "Selection Sort Worst Case");
+  fprintf(timeFile, "\n");
+
+  // Inputs are regenerated per block size; every repetition sorts a fresh
+  // copy of them in `work`
+  int *bestCase = (int *)malloc(NUM_COUNT * sizeof(int));
+  int *worstInsertion = (int *)malloc(NUM_COUNT * sizeof(int));
+  int *worstSelection = (int *)malloc(NUM_COUNT * sizeof(int));
+  int *work = (int *)malloc(NUM_COUNT * sizeof(int));
+  if (bestCase == NULL || worstInsertion == NULL || worstSelection == NULL ||
+      work == NULL) {
     printf("Memory allocation failed!\n");
+    free(bestCase);
+    free(worstInsertion);
+    free(worstSelection);
+    free(work);
+    fclose(timeFile);
     return;
   }
-  readNumbers(numbers, NUM_COUNT); // Read numbers from the file
 
-  for (int blockSize = 100; blockSize <= NUM_COUNT; blockSize += 100) {
-    // Create temporary arrays for sorting
-    int *tempInsertionBest = (int *)malloc(blockSize * sizeof(int));
-    int *tempInsertionWorst = (int *)malloc(blockSize * sizeof(int));
-    int *tempSelectionBest = (int *)malloc(blockSize * sizeof(int));
-    int *tempSelectionWorst = (int *)malloc(blockSize * sizeof(int));
-    if (tempInsertionBest == NULL || tempInsertionWorst == NULL ||
-        tempSelectionBest == NULL || tempSelectionWorst == NULL) {
-      printf("Memory allocation failed!\n");
-      return;
-    }
+  BenchConfig config = bench_default_config();
+  if (bench_pin_to_cpu(0) != 0)
+    printf("CPU pinning unavailable, timings may be noisier\n");
+  PerfCounters counters;
+  bench_enable_counters(&config, &counters);
 
+  for (int blockSize = 100; blockSize <= NUM_COUNT; blockSize += 100) {
     // Generate best and worst cases for Insertion Sort
-    generateBestCaseInsertion(tempInsertionBest, blockSize);
-    generateWorstCaseInsertion(tempInsertionWorst, blockSize);
-
-    // Generate best and worst cases for Selection Sort
-    generateBestCaseInsertion(tempSelectionBest,
-                              blockSize); // Best case for Selection Sort is the
-                                          // same as Insertion Sort
-    generateWorstCaseSelection(tempSelectionWorst, blockSize);
-
-    // Measure Insertion Sort time for best case
-    clock_t start = clock();
-    insertionSort(tempInsertionBest, blockSize);
-    clock_t stop = clock();
-    double insertionBestTime = (double)(stop - start) * 1000 /
-                               CLOCKS_PER_SEC; // Convert to milliseconds
-
-    // Measure Insertion Sort time for worst case
-    start = clock();
-    insertionSort(tempInsertionWorst, blockSize);
-    stop = clock();
-    double insertionWorstTime = (double)(stop - start) * 1000 /
-                                CLOCKS_PER_SEC; // Convert to milliseconds
-
-    // Measure Selection Sort time for best case
-    start = clock();
-    selectionSort(tempSelectionBest, blockSize);
-    stop = clock();
-    double selectionBestTime = (double)(stop - start) * 1000 /
-                               CLOCKS_PER_SEC; // Convert to milliseconds
-
-    // Measure Selection Sort time for worst case
-    start = clock();
-    selectionSort(tempSelectionWorst, blockSize);
-    stop = clock();
-    double selectionWorstTime = (double)(stop - start) * 1000 /
-                                CLOCKS_PER_SEC; // Convert to milliseconds
+    generateBestCaseInsertion(bestCase, blockSize);
+    generateWorstCaseInsertion(worstInsertion, blockSize);
+
+    // Best case for Selection Sort is the same as Insertion Sort
+    generateWorstCaseSelection(worstSelection, blockSize);
+
+    SortRun runs[4] = {{bestCase, work, blockSize, insertionSort},
+                       {worstInsertion, work, blockSize, insertionSort},
+                       {bestCase, work, blockSize, selectionSort},
+                       {worstSelection, work, blockSize, selectionSort}};
+    BenchStats stats[4];
+    for (int i = 0; i < 4; i++)
+      bench_measure(&config, prepareSortRun, runSortRun, &runs[i], &stats[i]);
 
     // Save results to the CSV file
-    fprintf(timeFile, "%d,%.2f,%.2f,%.2f,%.2f\n", blockSize, insertionBestTime,
-            insertionWorstTime, selectionBestTime, selectionWorstTime);
-    printf("Block Size: %d - Insertion Best: %.2f ms, Insertion Worst: %.2f "
-           "ms, Selection Best: %.2f ms, Selection Worst: %.2f ms\n",
-           blockSize, insertionBestTime, insertionWorstTime, selectionBestTime,
-           selectionWorstTime);
-
-    // Free temporary arrays
-    free(tempInsertionBest);
-    free(tempInsertionWorst);
-    free(tempSelectionBest);
-    free(tempSelectionWorst);
+    fprintf(timeFile, "%d", blockSize);
+    for (int i = 0; i < 4; i++) {
+      bench_csv_stats(timeFile, &stats[i]);
+      perf_csv_sample(timeFile, &stats[i].counters);
+    }
+    fprintf(timeFile, "\n");
+    printf("Block Size: %d - Insertion Best: %.4f ms, Insertion Worst: %.4f "
+           "ms, Selection Best: %.4f ms, Selection Worst: %.4f ms\n",
+           blockSize, stats[0].median_ms, stats[1].median_ms,
+           stats[2].median_ms, stats[3].median_ms);
   }
 
+  free(bestCase);
+  free(worstInsertion);
+  free(worstSelection);
+  perf_counters_close(&counters);
+  free(work);
   fclose(timeFile);
-  free(numbers);
 }
 
 int main() {
-  // Generate random numbers and save them to a file
-  generateRandomNumbers();
-
   // Measure sorting time for Insertion and Selection Sort
   measureSortingTime();
 
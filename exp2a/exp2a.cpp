@@ -1,61 +1,443 @@
 #include <bits/stdc++.h>
+#include "../common/bench_timer.h"
+#include "../common/dataset.h"
+#include "../common/workload.h"
+#include "../common/sort_network.h"
+#include "../common/work_stealing_pool.h"
 
 using namespace std;
 using namespace chrono;
 
 #define NUM_COUNT 100000
-#define OUTPUT_FILE "random_numbers.txt"
+#define OUTPUT_FILE "random_numbers.bin" // see common/dataset.h; convert old .txt files with common/convert_dataset.c
 #define TIME_RESULT_FILE "sorting_times.csv"
+#define EXTERNAL_RESULT_FILE "external_sort_passes.csv"
+#define INSERTION_RUN 32     // width of the runs the bottom-up merge sort builds with insertion sort
+#define NINTHER_THRESHOLD 128 // partitions larger than this pick the pivot with Tukey's ninther
+#define EXTERNAL_RUN_SIZE (1 << 24)  // default elements per in-memory run of the external sort (64 MiB)
+#define EXTERNAL_FAN_IN 16           // default number of runs merged at once
+#define EXTERNAL_IO_BUFFER (1 << 18) // elements buffered per run file during a merge (1 MiB)
+#define PARTITION_BLOCK 128   // elements classified per block by block_partition
+#define PARALLEL_CUTOFF 4096 // below this many elements the parallel sorts fall back to the serial code
+#define NETWORK_CUTOFF 32    // subarrays up to this size go to network_sort in the *Network engines
+#define NETWORK_RESULT_FILE "network_cutoff.csv"
+#define MERGE_RESULT_FILE "merge_kernel.csv"
+#define TIMSORT_MIN_MERGE 32  // natural_merge_sort extends runs to between half this and this many elements
+#define TIMSORT_MIN_GALLOP 7  // wins in a row after which a merge starts galloping
+#define SAMPLE_SORT_CUTOFF (1 << 14) // sample_sort hands subarrays up to this size to intro_sort
+#define SAMPLE_SORT_LOG_BUCKETS 8    // at most 2^8 buckets per level, so a bucket index fits in a byte
+#define SAMPLE_OVERSAMPLING 16       // sample elements drawn per bucket to pick the splitters
+#define SCALING_RESULT_FILE "sample_sort_scaling.csv"
+#define PAYLOAD_RESULT_FILE "payload_sort.csv"
+#define DECISION_LOG_FILE "sort_decisions.csv"
+#define IN_PLACE_BUFFER 256  // stack buffer of in_place_merge_sort, in ints
+#define HEAP_HEADER 16       // bytes in front of every heap block, keeps malloc's alignment
+#define ADAPTIVE_SAMPLE 256            // positions adaptive_sort samples for inversions and duplicates
+#define ADAPTIVE_MIN_AVG_RUN 32        // natural runs at least this long on average go to natural_merge_sort
+#define ADAPTIVE_ORDERED_RATIO 0.02    // sampled inversion ratio below which (or above 1 minus which) input counts as presorted
+#define ADAPTIVE_RADIX_MIN 2048        // below this many elements radix_sort is not considered
+#define ADAPTIVE_DUPLICATE_RATIO 0.25  // distinct ratio below which a wide key range goes to intro_sort's 3-way partition
 
 using namespace std;
 
-void generate_random_numbers()
+// Counts heap allocations and live heap bytes so the benchmark can report how
+// many allocations each sort makes and how much extra memory it peaks at.
+// Every block carries its size in a HEAP_HEADER-byte header.
+atomic<long long> allocation_count{0};
+atomic<long long> heap_bytes{0};
+atomic<long long> heap_peak{0};
+
+// noinline keeps GCC from seeing malloc()/free() through the replacements and
+// raising a false -Wmismatched-new-delete.
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocation_count.fetch_add(1, memory_order_relaxed);
+    char* p = (char*)malloc(size + HEAP_HEADER);
+    if (p == nullptr) throw bad_alloc();
+    *(size_t*)p = size;
+    long long now = heap_bytes.fetch_add(size, memory_order_relaxed) + size;
+    long long peak = heap_peak.load(memory_order_relaxed);
+    while (now > peak && !heap_peak.compare_exchange_weak(peak, now, memory_order_relaxed)) {}
+    return p + HEAP_HEADER;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept {
+    if (p == nullptr) return;
+    char* block = (char*)p - HEAP_HEADER;
+    heap_bytes.fetch_sub(*(size_t*)block, memory_order_relaxed);
+    free(block);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+// Uniform keys below 1,000,000 by default; WORKLOAD_DIST / WORKLOAD_SEED /
+// WORKLOAD_PARAM pick another distribution or a fixed seed (common/workload.h).
+void generate_random_numbers(uint64_t seed, unsigned threads)
 {
-    ofstream file(OUTPUT_FILE);
-    if (!file) {
-        cerr << "Error opening file for writing!" << endl;
+    WorkloadSpec spec = workload_from_env(WORKLOAD_UNIFORM, seed, NUM_COUNT, 0, 1000000);
+    vector<int32_t> numbers(NUM_COUNT);
+    workload_fill(&spec, numbers.data(), threads);
+    if (dataset_write(OUTPUT_FILE, numbers.data(), NUM_COUNT, DATASET_INT32, spec.seed) != 0)
+        cerr << "Error writing " << OUTPUT_FILE << "!" << endl;
+    else
+        cout << "Generated " << NUM_COUNT << " " << workload_names[spec.dist] << " numbers with seed " << spec.seed << endl;
+}
+
+// Slices the first `size` numbers out of the mapped dataset.
+void read_numbers(const int32_t* numbers, vector<int>& arr, int size) {
+    arr.assign(numbers, numbers + size);
+}
+
+void merge(vector<int>& arr, int left, int mid, int right) {
+    vector<int> temp(right - left + 1);
+    network_merge(arr.data() + left, mid - left + 1, arr.data() + mid + 1, right - mid, temp.data());
+
+    for (int i = left; i <= right; i++)
+        arr[i] = temp[i - left];
+}
+
+// Subarrays of at most `cutoff` elements (capped at NETWORK_MAX) are
+// finished by network_sort; 0 recurses down to single elements.
+void merge_sort(vector<int>& arr, int left, int right, int cutoff = 0) {
+    if (left >= right) return;
+    if (right - left + 1 <= min(cutoff, NETWORK_MAX)) {
+        network_sort(arr.data() + left, right - left + 1);
         return;
     }
-    for (int i = 0; i < NUM_COUNT; i++) {
-        file << rand() % 1000000 << "\n";
+
+    int mid = left + (right - left) / 2;
+    merge_sort(arr, left, mid, cutoff);
+    merge_sort(arr, mid + 1, right, cutoff);
+    merge(arr, left, mid, right);
+}
+
+template<typename T>
+void insertion_sort(T* arr, int left, int right) {
+    for (int i = left + 1; i <= right; i++) {
+        T key = arr[i];
+        int j = i - 1;
+        while (j >= left && key < arr[j]) {
+            arr[j + 1] = arr[j];
+            j--;
+        }
+        arr[j + 1] = key;
     }
-    file.close();
 }
 
-void read_numbers(vector<int>& arr, int size) {
-    ifstream file(OUTPUT_FILE);
-    if (!file) {
-        cerr << "Error opening file for reading!" << endl;
-        return;
+// Merges src[left..mid] and src[mid+1..right] into dst[left..right].
+void merge_into(const int* src, int* dst, int left, int mid, int right) {
+    network_merge(src + left, mid - left + 1, src + mid + 1, right - mid, dst + left);
+}
+
+// Iterative merge sort: insertion-sorts runs of INSERTION_RUN elements, then
+// merges runs of doubling width, alternating between arr and one scratch
+// buffer allocated up front. The only copy back happens once at the end,
+// and only if the number of passes is odd.
+void bottom_up_merge_sort(vector<int>& arr, int left, int right) {
+    int n = right - left + 1;
+    if (n <= 1) return;
+
+    for (int lo = left; lo <= right; lo += INSERTION_RUN)
+        insertion_sort(arr.data(), lo, min(lo + INSERTION_RUN - 1, right));
+    if (n <= INSERTION_RUN) return;
+
+    vector<int> buffer(arr.size());
+    int* src = arr.data();
+    int* dst = buffer.data();
+    for (int width = INSERTION_RUN; width < n; width *= 2) {
+        for (int lo = left; lo <= right; lo += 2 * width) {
+            int mid = min(lo + width - 1, right);
+            int hi = min(lo + 2 * width - 1, right);
+            merge_into(src, dst, lo, mid, hi);
+        }
+        swap(src, dst);
     }
-    arr.resize(size);
-    for (int i = 0; i < size; i++) {
-        file >> arr[i];
+    if (src != arr.data())
+        copy(src + left, src + right + 1, arr.data() + left);
+}
+
+// Sorts arr[lo..hi] by binary insertion, given that arr[lo..start) is
+// already sorted.
+void binary_insertion_sort(int* arr, int lo, int hi, int start) {
+    for (int i = max(start, lo + 1); i <= hi; i++) {
+        int key = arr[i];
+        int* pos = upper_bound(arr + lo, arr + i, key);
+        move_backward(pos, arr + i, arr + i + 1);
+        *pos = key;
     }
-    file.close();
 }
 
-void merge(vector<int>& arr, int left, int mid, int right) {
+// Length of the longest prefix of arr[0..n) that satisfies `pred` (which
+// must hold for a prefix only), found by probing offsets 1, 3, 7, ... and
+// then binary searching the last gap. Costs O(log k) for a prefix of k.
+template<typename Pred>
+int gallop_front(const int* arr, int n, Pred pred) {
+    int last = 0, ofs = 1;
+    while (ofs <= n && pred(arr[ofs - 1])) {
+        last = ofs;
+        ofs = 2 * ofs + 1;
+    }
+    int hi = min(ofs, n + 1) - 1; // pred(arr[hi]) is false or hi == n
+    return partition_point(arr + last, arr + hi, pred) - arr;
+}
+
+// Length of the longest suffix of arr[0..n) that satisfies `pred`.
+template<typename Pred>
+int gallop_back(const int* arr, int n, Pred pred) {
+    int last = 0, ofs = 1;
+    while (ofs <= n && pred(arr[n - ofs])) {
+        last = ofs;
+        ofs = 2 * ofs + 1;
+    }
+    int hi = min(ofs, n + 1) - 1;
+    const int* split = partition_point(arr + n - hi, arr + n - last, [&](int x) { return !pred(x); });
+    return arr + n - split;
+}
+
+// Timsort-style adaptive merge sort. The input is cut into natural runs
+// (non-descending, or descending and reversed in place); runs
+// shorter than min_run are extended with binary insertion sort. Runs are
+// merged from a stack whose lengths are kept roughly Fibonacci, so merges
+// stay balanced, and merges switch to galloping while one run keeps
+// winning. Already sorted or reversed input is a single run: O(n).
+class NaturalMergeSort {
+    struct Run {
+        int start, len;
+    };
+
+    int* arr;
+    vector<Run> runs;
     vector<int> temp;
-    int i = left, j = mid + 1;
+    int min_gallop = TIMSORT_MIN_GALLOP;
+
+    static int min_run_length(int n) {
+        int r = 0;
+        while (n >= TIMSORT_MIN_MERGE) {
+            r |= n & 1;
+            n >>= 1;
+        }
+        return n + r;
+    }
+
+    // Length of the run starting at lo, reversing it if it is descending.
+    // Equal keys are interchangeable ints, so unlike Timsort descending runs
+    // need not be strict and reversed input with duplicates stays one run.
+    int count_run(int lo, int hi) {
+        int i = lo + 1;
+        if (i > hi) return 1;
+        if (arr[i] < arr[lo]) {
+            while (i < hi && arr[i + 1] <= arr[i]) i++;
+            reverse(arr + lo, arr + i + 1);
+        } else {
+            while (i < hi && arr[i + 1] >= arr[i]) i++;
+        }
+        return i - lo + 1;
+    }
+
+    // Merges a[0..na) and the adjacent b[0..nb), na <= nb, front to back
+    // with a copied out to temp.
+    void merge_lo(int* a, int na, int* b, int nb) {
+        temp.assign(a, a + na);
+        int* t = temp.data();
+        int* dest = a;
+        int i = 0, j = 0;
+        while (i < na && j < nb) {
+            int wins_a = 0, wins_b = 0;
+            while (i < na && j < nb && wins_a < min_gallop && wins_b < min_gallop) {
+                if (b[j] < t[i]) {
+                    *dest++ = b[j++];
+                    wins_b++, wins_a = 0;
+                } else {
+                    *dest++ = t[i++];
+                    wins_a++, wins_b = 0;
+                }
+            }
+            while (i < na && j < nb) {
+                int bj = b[j];
+                int k = gallop_front(t + i, na - i, [bj](int x) { return x <= bj; });
+                dest = copy(t + i, t + i + k, dest);
+                i += k;
+                if (i == na) break;
+                int ti = t[i];
+                int m = gallop_front(b + j, nb - j, [ti](int x) { return x < ti; });
+                dest = copy(b + j, b + j + m, dest);
+                j += m;
+                if (k < TIMSORT_MIN_GALLOP && m < TIMSORT_MIN_GALLOP) {
+                    min_gallop++;
+                    break;
+                }
+                min_gallop = max(1, min_gallop - 1);
+            }
+        }
+        copy(t + i, t + na, dest); // the rest of b is already in place
+    }
+
+    // Merges a[0..na) and the adjacent b[0..nb), na > nb, back to front
+    // with b copied out to temp.
+    void merge_hi(int* a, int na, int* b, int nb) {
+        temp.assign(b, b + nb);
+        int* t = temp.data();
+        int* dest = b + nb;
+        int i = na, j = nb;
+        while (i > 0 && j > 0) {
+            int wins_a = 0, wins_b = 0;
+            while (i > 0 && j > 0 && wins_a < min_gallop && wins_b < min_gallop) {
+                if (t[j - 1] < a[i - 1]) {
+                    *--dest = a[--i];
+                    wins_a++, wins_b = 0;
+                } else {
+                    *--dest = t[--j];
+                    wins_b++, wins_a = 0;
+                }
+            }
+            while (i > 0 && j > 0) {
+                int tj = t[j - 1];
+                int k = gallop_back(a, i, [tj](int x) { return x > tj; });
+                dest = copy_backward(a + i - k, a + i, dest);
+                i -= k;
+                if (i == 0) break;
+                int ai = a[i - 1];
+                int m = gallop_back(t, j, [ai](int x) { return x >= ai; });
+                dest = copy_backward(t + j - m, t + j, dest);
+                j -= m;
+                if (k < TIMSORT_MIN_GALLOP && m < TIMSORT_MIN_GALLOP) {
+                    min_gallop++;
+                    break;
+                }
+                min_gallop = max(1, min_gallop - 1);
+            }
+        }
+        copy_backward(t, t + j, dest); // the rest of a is already in place
+    }
 
-    while (i <= mid && j <= right)
-        temp.push_back((arr[i] <= arr[j]) ? arr[i++] : arr[j++]);
+    void merge_at(int index) {
+        Run& first = runs[index];
+        Run second = runs[index + 1];
+        int* a = arr + first.start;
+        int* b = arr + second.start;
+        int na = first.len, nb = second.len;
+        first.len += second.len;
+        runs.erase(runs.begin() + index + 1);
 
-    while (i <= mid) temp.push_back(arr[i++]);
-    while (j <= right) temp.push_back(arr[j++]);
+        // Skip the prefix of a that is already below b[0] and the suffix of
+        // b that is already above the end of a.
+        int b0 = b[0];
+        int skip = gallop_front(a, na, [b0](int x) { return x <= b0; });
+        a += skip, na -= skip;
+        if (na == 0) return;
+        int a_last = a[na - 1];
+        nb -= gallop_back(b, nb, [a_last](int x) { return x >= a_last; });
+        if (nb == 0) return;
 
-    for (int i = left; i <= right; i++)
-        arr[i] = temp[i - left];
+        if (na <= nb) merge_lo(a, na, b, nb);
+        else merge_hi(a, na, b, nb);
+    }
+
+    // Restores len[n-2] > len[n-1] + len[n] and len[n-1] > len[n] over the
+    // top of the run stack (checking one entry deeper than the original
+    // Timsort, which could break the invariant).
+    void merge_collapse() {
+        while (runs.size() > 1) {
+            int n = (int)runs.size() - 2;
+            if ((n > 0 && runs[n - 1].len <= runs[n].len + runs[n + 1].len) ||
+                (n > 1 && runs[n - 2].len <= runs[n - 1].len + runs[n].len)) {
+                if (runs[n - 1].len < runs[n + 1].len) n--;
+            } else if (runs[n].len > runs[n + 1].len) {
+                break;
+            }
+            merge_at(n);
+        }
+    }
+
+public:
+    void sort(vector<int>& data, int low, int high) {
+        int n = high - low + 1;
+        if (n < 2) return;
+        arr = data.data();
+        runs.clear();
+        min_gallop = TIMSORT_MIN_GALLOP;
+
+        int min_run = min_run_length(n);
+        for (int lo = low; lo <= high;) {
+            int len = count_run(lo, high);
+            if (len < min_run) {
+                int forced = min(min_run, high - lo + 1);
+                binary_insertion_sort(arr, lo, lo + forced - 1, lo + len);
+                len = forced;
+            }
+            runs.push_back({lo, len});
+            merge_collapse();
+            lo += len;
+        }
+        while (runs.size() > 1) {
+            int n = (int)runs.size() - 2;
+            if (n > 0 && runs[n - 1].len < runs[n + 1].len) n--;
+            merge_at(n);
+        }
+    }
+};
+
+void natural_merge_sort(vector<int>& arr, int low, int high) {
+    NaturalMergeSort sorter;
+    sorter.sort(arr, low, high);
 }
 
-void merge_sort(vector<int>& arr, int left, int right) {
-    if (left >= right) return;
+// Stable merge of arr[lo..mid) and arr[mid..hi) with O(1) extra memory.
+// A run that fits in the fixed `buffer` (IN_PLACE_BUFFER ints) is merged
+// through it. Otherwise the longer run is cut in the middle, the cut is
+// binary-searched in the other run, the two middle blocks trade places with
+// a rotation, and both halves are merged the same way: the smaller one
+// recursively, so the stack stays O(log n), the larger one in the loop.
+void rotation_merge(int* arr, int lo, int mid, int hi, int* buffer) {
+    while (lo < mid && mid < hi && arr[mid] < arr[mid - 1]) {
+        int len1 = mid - lo, len2 = hi - mid;
+        if (len1 <= IN_PLACE_BUFFER) {
+            copy(arr + lo, arr + mid, buffer);
+            int i = 0, j = mid, k = lo;
+            while (i < len1 && j < hi) arr[k++] = (arr[j] < buffer[i]) ? arr[j++] : buffer[i++];
+            while (i < len1) arr[k++] = buffer[i++];
+            return;
+        }
+        if (len2 <= IN_PLACE_BUFFER) {
+            copy(arr + mid, arr + hi, buffer);
+            int i = mid - 1, j = len2 - 1, k = hi - 1;
+            while (i >= lo && j >= 0) arr[k--] = (buffer[j] < arr[i]) ? arr[i--] : buffer[j--];
+            while (j >= 0) arr[k--] = buffer[j--];
+            return;
+        }
 
-    int mid = left + (right - left) / 2;
-    merge_sort(arr, left, mid);
-    merge_sort(arr, mid + 1, right);
-    merge(arr, left, mid, right);
+        int cut1, cut2;
+        if (len1 > len2) {
+            cut1 = lo + len1 / 2;
+            cut2 = lower_bound(arr + mid, arr + hi, arr[cut1]) - arr;
+        } else {
+            cut2 = mid + len2 / 2;
+            cut1 = upper_bound(arr + lo, arr + mid, arr[cut2]) - arr;
+        }
+        rotate(arr + cut1, arr + mid, arr + cut2);
+        int new_mid = cut1 + (cut2 - mid);
+        if (new_mid - lo < hi - new_mid) {
+            rotation_merge(arr, lo, cut1, new_mid, buffer);
+            lo = new_mid;
+            mid = cut2;
+        } else {
+            rotation_merge(arr, new_mid, cut2, hi, buffer);
+            hi = new_mid;
+            mid = cut1;
+        }
+    }
+}
+
+// Bottom-up stable merge sort that never allocates: insertion-sorted runs
+// of INSERTION_RUN elements merged by rotation_merge through a stack buffer.
+void in_place_merge_sort(vector<int>& arr, int low, int high) {
+    if (low >= high) return;
+    int n = high - low + 1;
+    int buffer[IN_PLACE_BUFFER];
+    for (int lo = low; lo <= high; lo += INSERTION_RUN)
+        insertion_sort(arr.data(), lo, min(lo + INSERTION_RUN - 1, high));
+    for (int width = INSERTION_RUN; width < n; width *= 2)
+        for (int lo = low; lo + width <= high; lo += 2 * width)
+            rotation_merge(arr.data(), lo, lo + width, min(lo + 2 * width, high + 1), buffer);
 }
 
 int partition(vector<int>& arr, int low, int high) {
@@ -71,72 +453,1375 @@ int partition(vector<int>& arr, int low, int high) {
     return i - 1;
 }
 
-void quick_sort(vector<int>& arr, int low, int high) {
+void quick_sort(vector<int>& arr, int low, int high, int cutoff = 0) {
+    if (low < high && high - low + 1 <= min(cutoff, NETWORK_MAX)) {
+        network_sort(arr.data() + low, high - low + 1);
+        return;
+    }
     if (low < high) {
         int pi = partition(arr, low, high);
-        quick_sort(arr, low, pi - 1);
-        quick_sort(arr, pi + 1, high);
+        quick_sort(arr, low, pi - 1, cutoff);
+        quick_sort(arr, pi + 1, high, cutoff);
+    }
+}
+
+// Merge-path split: the number of elements taken from arr[a_lo..a_hi) when the
+// first `diag` elements of the merged output are produced.
+int merge_path_split(const vector<int>& arr, int a_lo, int a_hi, int b_lo, int b_hi, int diag) {
+    int lo = max(0, diag - (b_hi - b_lo));
+    int hi = min(diag, a_hi - a_lo);
+    while (lo < hi) {
+        int i = lo + (hi - lo) / 2;
+        if (arr[a_lo + i] <= arr[b_lo + diag - i - 1]) lo = i + 1;
+        else hi = i;
+    }
+    return lo;
+}
+
+void merge_range(const vector<int>& arr, vector<int>& temp, int i, int i_end, int j, int j_end, int k) {
+    network_merge(arr.data() + i, i_end - i, arr.data() + j, j_end - j, temp.data() + k);
+}
+
+// Merges output positions [out_lo, out_hi) of arr[left..mid] and arr[mid+1..right]
+// into temp, splitting the work along the merge path until pieces are small.
+void parallel_merge_part(vector<int>& arr, vector<int>& temp, int left, int mid, int right,
+                         int out_lo, int out_hi, int cutoff, WorkStealingPool& pool) {
+    if (out_hi - out_lo <= cutoff) {
+        int a_lo = merge_path_split(arr, left, mid + 1, mid + 1, right + 1, out_lo - left);
+        int a_hi = merge_path_split(arr, left, mid + 1, mid + 1, right + 1, out_hi - left);
+        int b_lo = (out_lo - left) - a_lo;
+        int b_hi = (out_hi - left) - a_hi;
+        merge_range(arr, temp, left + a_lo, left + a_hi, mid + 1 + b_lo, mid + 1 + b_hi, out_lo);
+        return;
+    }
+    int out_mid = out_lo + (out_hi - out_lo) / 2;
+    pool.fork_join(
+        [&] { parallel_merge_part(arr, temp, left, mid, right, out_lo, out_mid, cutoff, pool); },
+        [&] { parallel_merge_part(arr, temp, left, mid, right, out_mid, out_hi, cutoff, pool); });
+}
+
+void parallel_copy(const vector<int>& src, vector<int>& dst, int lo, int hi, int cutoff, WorkStealingPool& pool) {
+    if (hi - lo <= cutoff) {
+        copy(src.begin() + lo, src.begin() + hi, dst.begin() + lo);
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    pool.fork_join(
+        [&] { parallel_copy(src, dst, lo, mid, cutoff, pool); },
+        [&] { parallel_copy(src, dst, mid, hi, cutoff, pool); });
+}
+
+void parallel_merge_sort(vector<int>& arr, vector<int>& temp, int left, int right, int cutoff, WorkStealingPool& pool) {
+    if (right - left + 1 <= cutoff) {
+        merge_sort(arr, left, right);
+        return;
+    }
+
+    int mid = left + (right - left) / 2;
+    pool.fork_join(
+        [&] { parallel_merge_sort(arr, temp, left, mid, cutoff, pool); },
+        [&] { parallel_merge_sort(arr, temp, mid + 1, right, cutoff, pool); });
+
+    parallel_merge_part(arr, temp, left, mid, right, left, right + 1, cutoff, pool);
+    parallel_copy(temp, arr, left, right + 1, cutoff, pool);
+}
+
+void parallel_merge_sort(vector<int>& arr, int left, int right, WorkStealingPool& pool) {
+    if (left >= right) return;
+    vector<int> temp(arr.size());
+    parallel_merge_sort(arr, temp, left, right, PARALLEL_CUTOFF, pool);
+}
+
+// The comparison sorts from here to intro_sort are templates so that they
+// also sort the packed keys of argsort() and whole records; T only needs
+// operator<.
+template<typename T>
+void sift_down(vector<T>& arr, int low, int root, int n) {
+    T value = arr[low + root];
+    while (2 * root + 1 < n) {
+        int child = 2 * root + 1;
+        if (child + 1 < n && arr[low + child] < arr[low + child + 1]) child++;
+        if (!(value < arr[low + child])) break;
+        arr[low + root] = arr[low + child];
+        root = child;
+    }
+    arr[low + root] = value;
+}
+
+template<typename T>
+void heap_sort(vector<T>& arr, int low, int high) {
+    int n = high - low + 1;
+    for (int i = n / 2 - 1; i >= 0; i--)
+        sift_down(arr, low, i, n);
+    for (int end = n - 1; end > 0; end--) {
+        swap(arr[low], arr[low + end]);
+        sift_down(arr, low, 0, end);
+    }
+}
+
+template<typename T>
+int median_of_three(const vector<T>& arr, int a, int b, int c) {
+    if (arr[a] < arr[b]) {
+        if (arr[b] < arr[c]) return b;
+        return (arr[a] < arr[c]) ? c : a;
+    }
+    if (arr[a] < arr[c]) return a;
+    return (arr[b] < arr[c]) ? c : b;
+}
+
+// Median of three for small ranges, Tukey's ninther (median of three medians)
+// for large ones; sorted and reversed inputs both get a central pivot.
+template<typename T>
+int choose_pivot(const vector<T>& arr, int low, int high) {
+    int n = high - low + 1;
+    int mid = low + n / 2;
+    if (n <= NINTHER_THRESHOLD)
+        return median_of_three(arr, low, mid, high);
+    int step = n / 8;
+    int a = median_of_three(arr, low, low + step, low + 2 * step);
+    int b = median_of_three(arr, mid - step, mid, mid + step);
+    int c = median_of_three(arr, high - 2 * step, high - step, high);
+    return median_of_three(arr, a, b, c);
+}
+
+// Three-way (Dijkstra) partition around arr[pivot_index]. Afterwards
+// arr[low..lt-1] < pivot, arr[lt..gt] == pivot and arr[gt+1..high] > pivot,
+// so runs of equal keys are never partitioned again.
+template<typename T>
+void partition3(vector<T>& arr, int low, int high, int pivot_index, int& lt, int& gt) {
+    T pivot = arr[pivot_index];
+    lt = low;
+    gt = high;
+    int i = low;
+    while (i <= gt) {
+        if (arr[i] < pivot) swap(arr[lt++], arr[i++]);
+        else if (pivot < arr[i]) swap(arr[i], arr[gt--]);
+        else i++;
+    }
+}
+
+// Recurses only into the smaller side and loops on the larger one, so the
+// stack depth stays O(log n); once depth_limit partitions have been spent the
+// range is finished with heapsort to cap the worst case at O(n log n).
+template<typename T>
+void intro_sort_loop(vector<T>& arr, int low, int high, int depth_limit) {
+    while (high - low + 1 > INSERTION_RUN) {
+        if (depth_limit == 0) {
+            heap_sort(arr, low, high);
+            return;
+        }
+        depth_limit--;
+
+        int lt, gt;
+        partition3(arr, low, high, choose_pivot(arr, low, high), lt, gt);
+        if (lt - low < high - gt) {
+            intro_sort_loop(arr, low, lt - 1, depth_limit);
+            low = gt + 1;
+        } else {
+            intro_sort_loop(arr, gt + 1, high, depth_limit);
+            high = lt - 1;
+        }
+    }
+    insertion_sort(arr.data(), low, high);
+}
+
+template<typename T>
+void intro_sort(vector<T>& arr, int low, int high) {
+    if (low >= high) return;
+    int depth_limit = 2 * (int)log2(high - low + 1);
+    intro_sort_loop(arr, low, high, depth_limit);
+}
+
+// BlockQuicksort partition (Edelkamp & Weiss) around the pivot in arr[low].
+// Instead of branching on every comparison, each side classifies a block of
+// PARTITION_BLOCK elements at a time and records the offsets of misplaced
+// elements with branch-free increments; the recorded pairs are then swapped
+// in a batch. The last few blocks are finished with a plain Hoare scan.
+// Afterwards arr[low..p-1] < pivot <= arr[p+1..high]; returns p.
+int block_partition(vector<int>& arr, int low, int high) {
+    int pivot = arr[low];
+    int* first = arr.data() + low + 1;
+    int* last = arr.data() + high + 1;
+    unsigned char offsets_left[PARTITION_BLOCK], offsets_right[PARTITION_BLOCK];
+    int num_left = 0, num_right = 0, start_left = 0, start_right = 0;
+
+    while (last - first > 2 * PARTITION_BLOCK) {
+        if (num_left == 0) {
+            start_left = 0;
+            for (int i = 0; i < PARTITION_BLOCK; i++) {
+                offsets_left[num_left] = i;
+                num_left += !(first[i] < pivot);
+            }
+        }
+        if (num_right == 0) {
+            start_right = 0;
+            for (int i = 0; i < PARTITION_BLOCK; i++) {
+                offsets_right[num_right] = i;
+                num_right += (last[-1 - i] < pivot);
+            }
+        }
+
+        int num = min(num_left, num_right);
+        for (int k = 0; k < num; k++)
+            swap(first[offsets_left[start_left + k]], last[-1 - offsets_right[start_right + k]]);
+        num_left -= num;
+        num_right -= num;
+        start_left += num;
+        start_right += num;
+        if (num_left == 0) first += PARTITION_BLOCK;
+        if (num_right == 0) last -= PARTITION_BLOCK;
+    }
+
+    // Everything before `first` is < pivot and everything from `last` on is
+    // >= pivot; a half-processed block is simply scanned again here.
+    int* i = first;
+    int* j = last - 1;
+    while (true) {
+        while (i <= j && *i < pivot) i++;
+        while (i <= j && !(*j < pivot)) j--;
+        if (i >= j) break;
+        swap(*i++, *j--);
+    }
+    int p = (i - arr.data()) - 1;
+    swap(arr[low], arr[p]);
+    return p;
+}
+
+void block_quick_sort_loop(vector<int>& arr, int low, int high, int depth_limit) {
+    while (high - low + 1 > INSERTION_RUN) {
+        if (depth_limit == 0) {
+            heap_sort(arr, low, high);
+            return;
+        }
+        depth_limit--;
+
+        swap(arr[low], arr[choose_pivot(arr, low, high)]);
+        int p = block_partition(arr, low, high);
+        if (p == low) {
+            // Nothing is below the pivot, so it is the minimum and may be
+            // repeated many times; gather its copies so the next level does
+            // not peel them off one at a time.
+            int lt, gt;
+            partition3(arr, low, high, low, lt, gt);
+            low = gt + 1;
+            continue;
+        }
+        if (p - low < high - p) {
+            block_quick_sort_loop(arr, low, p - 1, depth_limit);
+            low = p + 1;
+        } else {
+            block_quick_sort_loop(arr, p + 1, high, depth_limit);
+            high = p - 1;
+        }
     }
+    insertion_sort(arr.data(), low, high);
 }
 
-void perform_experiment() {
+// Quicksort on block_partition, with the same pivot choice, depth limit and
+// smaller-side recursion as intro_sort.
+void block_quick_sort(vector<int>& arr, int low, int high) {
+    if (low >= high) return;
+    int depth_limit = 2 * (int)log2(high - low + 1);
+    block_quick_sort_loop(arr, low, high, depth_limit);
+}
+
+// LSD radix sort on 8-bit digits for signed or unsigned 32/64-bit keys.
+// One read over the input builds the histograms of every digit; a digit
+// whose histogram puts all keys in one bucket is skipped, so keys below
+// 1,000,000 only pay for three of the four passes of an int. Signed keys
+// are ordered by flipping the sign bit.
+// Bytes below skip_bytes are ignored, which sorts by the high part of the
+// key only; being an LSD sort, ties keep their input order.
+template<typename T>
+void radix_sort(vector<T>& arr, int low, int high, int skip_bytes = 0) {
+    static_assert(is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8), "radix_sort needs 32/64-bit integer keys");
+    using U = typename make_unsigned<T>::type;
+    const int passes = sizeof(T);
+    const U flip = is_signed<T>::value ? U(1) << (8 * sizeof(T) - 1) : 0;
+
+    int n = high - low + 1;
+    if (n <= 1) return;
+
+    size_t counts[sizeof(T)][256] = {};
+    for (int i = low; i <= high; i++) {
+        U key = U(arr[i]) ^ flip;
+        for (int p = skip_bytes; p < passes; p++)
+            counts[p][(key >> (8 * p)) & 0xFF]++;
+    }
+
+    vector<T> buffer(n);
+    T* src = arr.data() + low;
+    T* dst = buffer.data();
+    for (int p = skip_bytes; p < passes; p++) {
+        size_t* count = counts[p];
+        U first_digit = (U(src[0]) ^ flip) >> (8 * p) & 0xFF;
+        if (count[first_digit] == (size_t)n) continue;
+
+        size_t offset = 0;
+        for (int d = 0; d < 256; d++) {
+            size_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+        for (int i = 0; i < n; i++) {
+            U digit = (U(src[i]) ^ flip) >> (8 * p) & 0xFF;
+            dst[count[digit]++] = src[i];
+        }
+        swap(src, dst);
+    }
+    if (src != arr.data() + low)
+        copy(src, src + n, arr.data() + low);
+}
+
+// ---- Key-payload records ----
+// Records as a structure of arrays: keys in one vector<int>, payloads of
+// a fixed size in another. argsort() sorts (key, index) pairs packed into
+// one 64-bit word (key in the high half), so payloads are never touched
+// while sorting; sort_records() then moves every payload exactly once,
+// through the permutation. Because the index breaks ties, both backends
+// are stable.
+template<size_t Bytes>
+struct Payload {
+    char bytes[Bytes];
+};
+
+enum class SortBackend { Comparison, Radix };
+
+vector<int> argsort(const vector<int>& keys, SortBackend backend) {
+    int n = keys.size();
+    vector<int64_t> packed(n);
+    for (int i = 0; i < n; i++) packed[i] = (int64_t)keys[i] * 4294967296LL + i;
+    if (backend == SortBackend::Radix) radix_sort(packed, 0, n - 1, 4);
+    else intro_sort(packed, 0, n - 1);
+
+    vector<int> order(n);
+    for (int i = 0; i < n; i++) order[i] = (int)(packed[i] & 0xFFFFFFFF);
+    return order;
+}
+
+template<size_t Bytes>
+void sort_records(vector<int>& keys, vector<Payload<Bytes>>& payloads, SortBackend backend) {
+    vector<int> order = argsort(keys, backend);
+    vector<int> sorted_keys(keys.size());
+    vector<Payload<Bytes>> sorted_payloads(payloads.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        sorted_keys[i] = keys[order[i]];
+        sorted_payloads[i] = payloads[order[i]];
+    }
+    keys.swap(sorted_keys);
+    payloads.swap(sorted_payloads);
+}
+
+// The same records as an array of structures, for comparison: sorting
+// these moves the whole payload on every swap.
+template<size_t Bytes>
+struct Record {
+    int key;
+    Payload<Bytes> payload;
+
+    bool operator<(const Record& other) const { return key < other.key; }
+};
+
+// ---- Sample sort ----
+// Parallel super scalar sample sort. One level:
+//   1. 2^b - 1 splitters are picked from a sorted random sample of
+//      SAMPLE_OVERSAMPLING candidates per bucket and laid out as an
+//      implicit binary search tree, so classifying an element is b steps
+//      of j = 2j + (x > tree[j]) with no branch to mispredict.
+//   2. Every thread classifies one chunk, recording each element's bucket
+//      in `oracle` and counting the bucket sizes of its chunk.
+//   3. A prefix sum over (bucket, chunk) gives each chunk its own slice of
+//      every bucket, so the single scatter pass into temp needs no locks.
+//   4. Buckets are copied back and sorted in parallel, recursively, down
+//      to SAMPLE_SORT_CUTOFF elements where intro_sort takes over.
+// temp and oracle are scratch space indexed like arr.
+void sample_sort(vector<int>& arr, vector<int>& temp, vector<uint8_t>& oracle, int low, int high, WorkStealingPool& pool) {
+    int n = high - low + 1;
+    if (n <= SAMPLE_SORT_CUTOFF) {
+        intro_sort(arr, low, high);
+        return;
+    }
+
+    int log_buckets = 1;
+    while (log_buckets < SAMPLE_SORT_LOG_BUCKETS && (n >> (log_buckets + 1)) >= SAMPLE_SORT_CUTOFF / 4) log_buckets++;
+    const int buckets = 1 << log_buckets;
+
+    vector<int> sample(buckets * SAMPLE_OVERSAMPLING);
+    for (size_t i = 0; i < sample.size(); i++)
+        sample[i] = arr[low + workload_below(workload_random(n, low, i), n)];
+    sort(sample.begin(), sample.end());
+    vector<int> tree(buckets);
+    // tree[j] has children 2j and 2j + 1; an in-order walk lists the splitters in order.
+    function<void(int, int, int)> build = [&](int j, int lo, int hi) {
+        int mid = lo + (hi - lo) / 2;
+        tree[j] = sample[(mid + 1) * SAMPLE_OVERSAMPLING - 1];
+        if (2 * j < buckets) {
+            build(2 * j, lo, mid);
+            build(2 * j + 1, mid + 1, hi);
+        }
+    };
+    build(1, 0, buckets - 1);
+
+    const int chunks = max(1, min((int)pool.size(), n / SAMPLE_SORT_CUTOFF));
+    vector<long long> counts((size_t)chunks * buckets, 0);
+    auto chunk_begin = [&](int c) { return low + (int)((long long)n * c / chunks); };
+
+    parallel_for(pool, 0, chunks, [&](int c) {
+        long long* count = &counts[(size_t)c * buckets];
+        const int* t = tree.data();
+        for (int i = chunk_begin(c), end = chunk_begin(c + 1); i < end; i++) {
+            int x = arr[i], j = 1;
+            for (int level = 0; level < log_buckets; level++) j = 2 * j + (x > t[j]);
+            oracle[i] = (uint8_t)(j - buckets);
+            count[j - buckets]++;
+        }
+    });
+
+    // offsets[c * buckets + b]: where chunk c writes its first element of bucket b.
+    vector<long long> offsets((size_t)chunks * buckets), bucket_start(buckets + 1);
+    long long pos = low;
+    for (int b = 0; b < buckets; b++) {
+        bucket_start[b] = pos;
+        for (int c = 0; c < chunks; c++) {
+            offsets[(size_t)c * buckets + b] = pos;
+            pos += counts[(size_t)c * buckets + b];
+        }
+    }
+    bucket_start[buckets] = pos;
+    for (int b = 0; b < buckets; b++) {
+        if (bucket_start[b + 1] - bucket_start[b] == n) { // every element equal to one splitter
+            intro_sort(arr, low, high);
+            return;
+        }
+    }
+
+    parallel_for(pool, 0, chunks, [&](int c) {
+        long long* offset = &offsets[(size_t)c * buckets];
+        for (int i = chunk_begin(c), end = chunk_begin(c + 1); i < end; i++)
+            temp[offset[oracle[i]]++] = arr[i];
+    });
+
+    parallel_for(pool, 0, buckets, [&](int b) {
+        int lo = bucket_start[b], hi = bucket_start[b + 1] - 1;
+        copy(temp.begin() + lo, temp.begin() + hi + 1, arr.begin() + lo);
+        sample_sort(arr, temp, oracle, lo, hi, pool);
+    });
+}
+
+void sample_sort(vector<int>& arr, int low, int high, WorkStealingPool& pool) {
+    if (high - low + 1 <= SAMPLE_SORT_CUTOFF) {
+        intro_sort(arr, low, high);
+        return;
+    }
+    vector<int> temp(arr.size());
+    vector<uint8_t> oracle(arr.size());
+    sample_sort(arr, temp, oracle, low, high, pool);
+}
+
+// ---- Adaptive dispatch ----
+// Adaptive dispatcher: one pass plus a small random sample describe the
+// input, and adaptive_sort() hands it to the strategy that suits it.
+// (Named adaptive_sort rather than sort so it does not clash with
+// std::sort under `using namespace std`.)
+enum class SortStrategy { Insertion, NaturalMerge, Intro, Radix };
+
+static const char* const sort_strategy_names[] = {"InsertionSort", "NaturalMergeSort", "IntroSort", "RadixSort"};
+
+struct SortDecision {
+    int n = 0;
+    int runs = 0;               // non-descending runs, i.e. descents + 1
+    int descending_runs = 0;    // non-ascending runs, i.e. ascents + 1
+    double inversion_ratio = 0; // fraction of sampled pairs i < j with arr[i] > arr[j]
+    double distinct_ratio = 1;  // distinct keys among the sampled keys
+    long long key_range = 0;    // max - min
+    SortStrategy strategy = SortStrategy::Insertion;
+    const char* reason = "";
+};
+
+SortDecision choose_sort_strategy(const vector<int>& arr, int low, int high) {
+    SortDecision d;
+    d.n = high - low + 1;
+    if (d.n <= INSERTION_RUN) {
+        d.strategy = SortStrategy::Insertion;
+        d.reason = "small input";
+        return d;
+    }
+
+    int descents = 0, ascents = 0, lo = arr[low], hi = arr[low];
+    for (int i = low + 1; i <= high; i++) {
+        descents += arr[i] < arr[i - 1];
+        ascents += arr[i] > arr[i - 1];
+        lo = min(lo, arr[i]);
+        hi = max(hi, arr[i]);
+    }
+    d.runs = descents + 1;
+    d.descending_runs = ascents + 1;
+    d.key_range = (long long)hi - lo;
+
+    // Sampled at fixed pseudo-random positions, so a given input always
+    // gets the same decision.
+    int inversions = 0, pairs = 0;
+    vector<int> sample(ADAPTIVE_SAMPLE), positions(ADAPTIVE_SAMPLE);
+    for (int s = 0; s < ADAPTIVE_SAMPLE; s++) {
+        int i = low + workload_below(workload_random(d.n, 3, 2 * s), d.n);
+        int j = low + workload_below(workload_random(d.n, 3, 2 * s + 1), d.n);
+        if (i > j) swap(i, j);
+        if (i < j) {
+            inversions += arr[i] > arr[j];
+            pairs++;
+        }
+        sample[s] = arr[i];
+        positions[s] = i;
+    }
+    d.inversion_ratio = pairs ? (double)inversions / pairs : 0;
+    // Small inputs get sampled positions more than once; only count each once.
+    sort(sample.begin(), sample.end());
+    sort(positions.begin(), positions.end());
+    d.distinct_ratio = (double)(unique(sample.begin(), sample.end()) - sample.begin()) /
+                       (unique(positions.begin(), positions.end()) - positions.begin());
+
+    if (min(d.runs, d.descending_runs) <= d.n / ADAPTIVE_MIN_AVG_RUN) {
+        d.strategy = SortStrategy::NaturalMerge;
+        d.reason = "long natural runs";
+    } else if (d.inversion_ratio <= ADAPTIVE_ORDERED_RATIO || d.inversion_ratio >= 1 - ADAPTIVE_ORDERED_RATIO) {
+        d.strategy = SortStrategy::NaturalMerge;
+        d.reason = "nearly sorted or reversed";
+    } else if (d.n < ADAPTIVE_RADIX_MIN) {
+        d.strategy = SortStrategy::Intro;
+        d.reason = "too small for radix";
+    } else if (d.key_range < (1LL << 24)) {
+        d.strategy = SortStrategy::Radix;
+        d.reason = "narrow key range";
+    } else if (d.distinct_ratio < ADAPTIVE_DUPLICATE_RATIO) {
+        d.strategy = SortStrategy::Intro;
+        d.reason = "many duplicates";
+    } else {
+        d.strategy = SortStrategy::Radix;
+        d.reason = "large random input";
+    }
+    return d;
+}
+
+// Returns the decision it acted on, so callers can log exactly what ran.
+SortDecision adaptive_sort(vector<int>& arr, int low, int high) {
+    SortDecision d = choose_sort_strategy(arr, low, high);
+    if (low >= high) return d;
+    switch (d.strategy) {
+    case SortStrategy::Insertion: insertion_sort(arr.data(), low, high); break;
+    case SortStrategy::NaturalMerge: natural_merge_sort(arr, low, high); break;
+    case SortStrategy::Intro: intro_sort(arr, low, high); break;
+    case SortStrategy::Radix: radix_sort(arr, low, high); break;
+    }
+    return d;
+}
+
+void write_decision_header(ofstream& file) {
+    file << "Block Size,Case,Runs,Descending Runs,Inversion Ratio,Distinct Ratio,Key Range,Strategy,Reason\n";
+}
+
+void write_decision(ofstream& file, int block_size, const char* case_name, const SortDecision& d) {
+    file << block_size << "," << case_name << "," << d.runs << "," << d.descending_runs << "," << d.inversion_ratio << ","
+         << d.distinct_ratio << "," << d.key_range << "," << sort_strategy_names[(int)d.strategy] << "," << d.reason << "\n";
+}
+
+// ---- Selection ----
+// Order statistics without a full sort, built on the same choose_pivot and
+// partition3 kernel as intro_sort.
+
+void nth_select(vector<int>& arr, int low, int high, int k);
+
+// Deterministic pivot: the median of the medians of groups of five. Slower
+// than choose_pivot but guarantees a 30/70 split, which bounds select()
+// to O(n) even on adversarial input.
+int median_of_medians(vector<int>& arr, int low, int high) {
+    int n = high - low + 1;
+    if (n <= 5) {
+        insertion_sort(arr.data(), low, high);
+        return low + n / 2;
+    }
+    int medians = 0;
+    for (int group = low; group <= high; group += 5) {
+        int group_end = min(group + 4, high);
+        insertion_sort(arr.data(), group, group_end);
+        swap(arr[low + medians++], arr[group + (group_end - group) / 2]);
+    }
+    int mid = low + medians / 2;
+    nth_select(arr, low, low + medians - 1, mid);
+    return mid;
+}
+
+// Introselect: rearranges arr[low..high] so that arr[k] holds the value a
+// full sort would put there, with nothing larger before it and nothing
+// smaller after it. Uses quickselect with choose_pivot and switches to
+// median-of-medians pivots once 2*log2(n) partitions have not finished.
+void nth_select(vector<int>& arr, int low, int high, int k) {
+    int depth_limit = 2 * (int)log2(max(high - low + 1, 1));
+    while (high - low + 1 > INSERTION_RUN) {
+        int pivot = (depth_limit-- > 0) ? choose_pivot(arr, low, high) : median_of_medians(arr, low, high);
+        int lt, gt;
+        partition3(arr, low, high, pivot, lt, gt);
+        if (k < lt) high = lt - 1;
+        else if (k > gt) low = gt + 1;
+        else return;
+    }
+    insertion_sort(arr.data(), low, high);
+}
+
+// Sorts the k smallest elements of arr[low..high] into arr[low..low+k-1];
+// the rest of the range is left in unspecified order.
+void partial_sort_k(vector<int>& arr, int low, int high, int k) {
+    k = min(k, high - low + 1);
+    if (k <= 0) return;
+    if (low + k - 1 < high) nth_select(arr, low, high, low + k - 1);
+    intro_sort(arr, low, low + k - 1);
+}
+
+// Keeps the k smallest values seen so far in a max-heap, so a stream of n
+// values costs O(n log k) time and O(k) memory.
+class BoundedTopK {
+    vector<int> heap;
+    size_t k;
+
+public:
+    explicit BoundedTopK(size_t k) : k(k) { heap.reserve(k); }
+
+    void push(int value) {
+        if (heap.size() < k) {
+            heap.push_back(value);
+            push_heap(heap.begin(), heap.end());
+        } else if (k > 0 && value < heap.front()) {
+            pop_heap(heap.begin(), heap.end());
+            heap.back() = value;
+            push_heap(heap.begin(), heap.end());
+        }
+    }
+
+    // Ascending; empties the heap.
+    vector<int> take_sorted() {
+        sort_heap(heap.begin(), heap.end());
+        return move(heap);
+    }
+};
+
+void heap_top_k(vector<int>& arr, int low, int high, int k) {
+    BoundedTopK top(k);
+    for (int i = low; i <= high; i++) top.push(arr[i]);
+    vector<int> smallest = top.take_sorted();
+    copy(smallest.begin(), smallest.end(), arr.begin() + low);
+}
+
+// Streams an int32 dataset from disk and returns its k smallest values in
+// ascending order; the file never has to fit in memory.
+bool streaming_top_k(const string& path, int k, vector<int>& result) {
+    FILE* in = fopen(path.c_str(), "rb");
+    DatasetHeader header;
+    if (!in || dataset_read_header(in, &header) != 0 || header.elem_type != DATASET_INT32) {
+        cerr << "Error opening " << path << " as an int32 dataset!" << endl;
+        if (in) fclose(in);
+        return false;
+    }
+    BoundedTopK top(max(k, 0));
+    vector<int32_t> buffer(EXTERNAL_IO_BUFFER);
+    size_t got;
+    while ((got = fread(buffer.data(), sizeof(int32_t), buffer.size(), in)) > 0) {
+        for (size_t i = 0; i < got; i++) top.push(buffer[i]);
+    }
+    fclose(in);
+    result = top.take_sorted();
+    return true;
+}
+
+void perform_top_k(const string& path, int k) {
+    vector<int> result;
+    double start = bench_now_ms();
+    if (!streaming_top_k(path, k, result)) return;
+    double elapsed = bench_now_ms() - start;
+
+    cout << "Streaming top-" << k << " of " << path << " took " << elapsed << " ms";
+    if (!result.empty()) cout << " | smallest: " << result.front() << " | k-th smallest: " << result.back();
+    cout << endl;
+}
+
+template<typename Func>
+long long count_allocations(Func f) {
+    long long before = allocation_count.load();
+    f();
+    return allocation_count.load() - before;
+}
+
+// Peak heap bytes allocated by f on top of what was live when it started.
+template<typename Func>
+long long peak_heap_bytes(Func f) {
+    long long before = heap_bytes.load();
+    heap_peak.store(before);
+    f();
+    return heap_peak.load() - before;
+}
+
+// Adapts bench_measure() from common/bench_timer.h to lambdas: prepare()
+// runs untimed before every repetition, run() is the timed region.
+template<typename Prepare, typename Run>
+BenchStats bench(const BenchConfig& config, Prepare prepare, Run run) {
+    struct Context {
+        Prepare& prepare;
+        Run& run;
+    } context{prepare, run};
+    BenchStats stats;
+    bench_measure(&config,
+        [](void* c) { static_cast<Context*>(c)->prepare(); },
+        [](void* c) { static_cast<Context*>(c)->run(); },
+        &context, &stats);
+    return stats;
+}
+
+void write_stats_header(ofstream& file, const string& name) {
+    file << "," << name << " Median (ms)," << name << " Min (ms)," << name << " P95 (ms)," << name << " Stddev (ms)";
+}
+
+void write_stats(ofstream& file, const BenchStats& stats) {
+    file << "," << stats.median_ms << "," << stats.min_ms << "," << stats.p95_ms << "," << stats.stddev_ms;
+}
+
+void write_counters_header(ofstream& file, const string& name) {
+    for (const char* counter : perf_counter_names)
+        file << "," << name << " " << counter;
+}
+
+void write_counters(ofstream& file, const PerfSample& sample) {
+    for (long long value : sample.value) {
+        if (value < 0) file << ",NA";
+        else file << "," << value;
+    }
+}
+
+// ---- External merge sort ----
+// Sorts a dataset larger than memory: the input is streamed in runs of
+// run_size elements, each run is sorted in memory with radix_sort and
+// written to a temporary file, and then up to fan_in runs at a time are
+// merged through a loser tree until one run is left. Every run file is read
+// and written sequentially through EXTERNAL_IO_BUFFER-sized buffers.
+
+struct ExternalPassStats {
+    string name;
+    int runs_in, runs_out;
+    long long bytes_read, bytes_written;
+    double ms;
+};
+
+class RunReader {
+    FILE* file;
+    vector<int32_t> buffer;
+    size_t pos = 0, len = 0;
+    long long remaining;
+    long long& bytes_read;
+
+public:
+    RunReader(const string& path, long long count, long long& bytes_read)
+        : file(fopen(path.c_str(), "rb")), buffer(EXTERNAL_IO_BUFFER), remaining(count), bytes_read(bytes_read) {
+        if (!file) cerr << "Error opening run file " << path << "!" << endl;
+        else refill();
+    }
+    ~RunReader() {
+        if (file) fclose(file);
+    }
+
+    bool refill() {
+        pos = 0;
+        len = 0;
+        if (!file || remaining == 0) return false;
+        size_t want = min<long long>(buffer.size(), remaining);
+        len = fread(buffer.data(), sizeof(int32_t), want, file);
+        remaining -= len;
+        bytes_read += len * sizeof(int32_t);
+        return len > 0;
+    }
+
+    bool exhausted() const { return pos == len; }
+    int32_t current() const { return buffer[pos]; }
+    void advance() {
+        if (++pos == len) refill();
+    }
+};
+
+class RunWriter {
+    FILE* file;
+    vector<int32_t> buffer;
+    size_t len = 0;
+    long long& bytes_written;
+
+public:
+    RunWriter(FILE* file, long long& bytes_written)
+        : file(file), buffer(EXTERNAL_IO_BUFFER), bytes_written(bytes_written) {}
+    ~RunWriter() { flush(); }
+
+    void push(int32_t value) {
+        buffer[len++] = value;
+        if (len == buffer.size()) flush();
+    }
+
+    void flush() {
+        if (len == 0) return;
+        if (fwrite(buffer.data(), sizeof(int32_t), len, file) != len)
+            cerr << "Error writing run file!" << endl;
+        bytes_written += len * sizeof(int32_t);
+        len = 0;
+    }
+};
+
+// Tournament tree over k runs: tree[1..k-1] hold the loser of each match and
+// tree[0] the overall winner, so replacing the winner costs one comparison
+// per level (log2 k) instead of the 2*log2 k of a binary heap.
+class LoserTree {
+    vector<unique_ptr<RunReader>>& runs;
+    vector<int> tree;
+    int k;
+
+    // Exhausted runs lose every match; ties go to the lower run index.
+    bool beats(int a, int b) const {
+        if (runs[a]->exhausted()) return false;
+        if (runs[b]->exhausted()) return true;
+        int32_t x = runs[a]->current(), y = runs[b]->current();
+        return x < y || (x == y && a < b);
+    }
+
+public:
+    explicit LoserTree(vector<unique_ptr<RunReader>>& runs) : runs(runs), tree(max<size_t>(runs.size(), 1)), k(runs.size()) {
+        vector<int> winner(2 * k);
+        for (int i = 0; i < k; i++) winner[k + i] = i;
+        for (int node = k - 1; node >= 1; node--) {
+            int a = winner[2 * node], b = winner[2 * node + 1];
+            winner[node] = beats(a, b) ? a : b;
+            tree[node] = beats(a, b) ? b : a;
+        }
+        tree[0] = (k > 1) ? winner[1] : 0;
+    }
+
+    bool empty() const { return runs[tree[0]]->exhausted(); }
+    int32_t top() const { return runs[tree[0]]->current(); }
+
+    void pop() {
+        int w = tree[0];
+        runs[w]->advance();
+        for (int node = (w + k) / 2; node >= 1; node /= 2) {
+            if (beats(tree[node], w)) swap(tree[node], w);
+        }
+        tree[0] = w;
+    }
+};
+
+string run_file_name(const string& output, int pass, int index) {
+    return output + ".pass" + to_string(pass) + ".run" + to_string(index) + ".tmp";
+}
+
+// Returns false (after printing why) if the sort could not be completed.
+bool external_sort(const string& input, const string& output, long long run_size, int fan_in, vector<ExternalPassStats>& stats) {
+    FILE* in = fopen(input.c_str(), "rb");
+    DatasetHeader header;
+    if (!in || dataset_read_header(in, &header) != 0 || header.elem_type != DATASET_INT32) {
+        cerr << "Error opening " << input << " as an int32 dataset!" << endl;
+        if (in) fclose(in);
+        return false;
+    }
+    run_size = max(run_size, 1LL);
+    fan_in = max(fan_in, 2);
+    // Deletes runs [from, to) of a pass; every early return first removes
+    // the run files that are still on disk.
+    auto remove_runs = [&](int pass, size_t from, size_t to) {
+        for (size_t r = from; r < to; r++) remove(run_file_name(output, pass, r).c_str());
+    };
+
+    // Pass 0: run formation.
+    ExternalPassStats formation{"runs", 1, 0, (long long)sizeof(header), 0, 0};
+    vector<long long> run_lengths;
+    vector<int> chunk;
+    auto start = high_resolution_clock::now();
+    for (long long done = 0; done < (long long)header.count; ) {
+        long long want = min<long long>(run_size, header.count - done);
+        chunk.resize(want);
+        size_t got = fread(chunk.data(), sizeof(int32_t), want, in);
+        formation.bytes_read += got * sizeof(int32_t);
+        if ((long long)got != want) {
+            cerr << "Unexpected end of " << input << "!" << endl;
+            fclose(in);
+            remove_runs(0, 0, run_lengths.size());
+            return false;
+        }
+        radix_sort(chunk, 0, want - 1);
+
+        FILE* run = fopen(run_file_name(output, 0, run_lengths.size()).c_str(), "wb");
+        if (!run || fwrite(chunk.data(), sizeof(int32_t), want, run) != (size_t)want) {
+            cerr << "Error writing run file!" << endl;
+            if (run) fclose(run);
+            fclose(in);
+            remove_runs(0, 0, run_lengths.size() + 1);
+            return false;
+        }
+        fclose(run);
+        formation.bytes_written += want * sizeof(int32_t);
+        run_lengths.push_back(want);
+        done += want;
+    }
+    fclose(in);
+    chunk = vector<int>();
+    formation.runs_out = run_lengths.size();
+    formation.ms = duration<double, milli>(high_resolution_clock::now() - start).count();
+    stats.push_back(formation);
+
+    // Merge passes; the last one writes the output dataset directly.
+    for (int pass = 1; ; pass++) {
+        bool last = (int)run_lengths.size() <= fan_in;
+        ExternalPassStats merge_pass{"merge " + to_string(pass), (int)run_lengths.size(), 0, 0, 0, 0};
+        start = high_resolution_clock::now();
+
+        vector<long long> next_lengths;
+        for (size_t group = 0; group < run_lengths.size() || (group == 0 && last); group += fan_in) {
+            size_t group_end = min(run_lengths.size(), group + fan_in);
+            string target = last ? output : run_file_name(output, pass, next_lengths.size());
+            FILE* out = fopen(target.c_str(), "wb");
+            if (!out) {
+                cerr << "Error opening " << target << " for writing!" << endl;
+                remove_runs(pass - 1, group, run_lengths.size());
+                remove_runs(pass, 0, next_lengths.size());
+                return false;
+            }
+            long long total = 0;
+            for (size_t r = group; r < group_end; r++) total += run_lengths[r];
+            if (last) {
+                dataset_write_header(out, total, DATASET_INT32, header.seed);
+                merge_pass.bytes_written += sizeof(DatasetHeader);
+            }
+            {
+                vector<unique_ptr<RunReader>> readers;
+                for (size_t r = group; r < group_end; r++)
+                    readers.push_back(make_unique<RunReader>(run_file_name(output, pass - 1, r), run_lengths[r], merge_pass.bytes_read));
+                RunWriter writer(out, merge_pass.bytes_written);
+                if (!readers.empty()) {
+                    LoserTree tree(readers);
+                    while (!tree.empty()) {
+                        writer.push(tree.top());
+                        tree.pop();
+                    }
+                }
+            }
+            fclose(out);
+            for (size_t r = group; r < group_end; r++)
+                remove(run_file_name(output, pass - 1, r).c_str());
+            next_lengths.push_back(total);
+            if (last) break;
+        }
+
+        run_lengths = next_lengths;
+        merge_pass.runs_out = run_lengths.size();
+        merge_pass.ms = duration<double, milli>(high_resolution_clock::now() - start).count();
+        stats.push_back(merge_pass);
+        if (last) return true;
+    }
+}
+
+void perform_external_sort(const string& input, const string& output, long long run_size, int fan_in) {
+    vector<ExternalPassStats> stats;
+    if (!external_sort(input, output, run_size, fan_in, stats)) return;
+
+    ofstream file(EXTERNAL_RESULT_FILE);
+    if (!file) {
+        cerr << "Error opening file for writing results!" << endl;
+        return;
+    }
+    file << "Pass,Runs In,Runs Out,Bytes Read,Bytes Written,Time (ms)\n";
+    for (const auto& pass : stats) {
+        file << pass.name << "," << pass.runs_in << "," << pass.runs_out << "," << pass.bytes_read << "," << pass.bytes_written << "," << pass.ms << "\n";
+        cout << "Pass: " << pass.name << " | Runs: " << pass.runs_in << " -> " << pass.runs_out << " | Read: " << pass.bytes_read
+            << " bytes | Written: " << pass.bytes_written << " bytes | Time: " << pass.ms << " ms" << endl;
+    }
+    cout << "External sort complete. Sorted data in " << output << ", pass statistics in " << EXTERNAL_RESULT_FILE << "." << endl;
+}
+
+struct SortEngine {
+    string name;
+    function<void(vector<int>&, int, int)> sort;
+};
+
+void perform_experiment(WorkStealingPool& pool) {
+    Dataset dataset;
+    if (dataset_open(OUTPUT_FILE, &dataset) != 0 || dataset_int32(&dataset) == NULL || dataset.header.count < NUM_COUNT) {
+        cerr << "Error opening " << OUTPUT_FILE << " for reading!" << endl;
+        return;
+    }
+    const int32_t* numbers = dataset_int32(&dataset);
+
     ofstream file(TIME_RESULT_FILE);
     if (!file) {
         cerr << "Error opening file for writing results!" << endl;
+        dataset_close(&dataset);
         return;
     }
-    file << "Block Size,QuickSort Random (ms),MergeSort Random (ms),QuickSort Best (ms),MergeSort Best (ms),QuickSort Worst (ms),MergeSort Worst (ms)\n";
+
+    SortDecision adaptive_decision; // what the last timed adaptive_sort call did
+    vector<SortEngine> engines = {
+        {"QuickSort", [](vector<int>& arr, int low, int high) { quick_sort(arr, low, high); }},
+        {"QuickSortNetwork", [](vector<int>& arr, int low, int high) { quick_sort(arr, low, high, NETWORK_CUTOFF); }},
+        {"MergeSort", [](vector<int>& arr, int low, int high) { merge_sort(arr, low, high); }},
+        {"MergeSortNetwork", [](vector<int>& arr, int low, int high) { merge_sort(arr, low, high, NETWORK_CUTOFF); }},
+        {"ParallelMergeSort", [&pool](vector<int>& arr, int low, int high) { parallel_merge_sort(arr, low, high, pool); }},
+        {"SampleSort", [&pool](vector<int>& arr, int low, int high) { sample_sort(arr, low, high, pool); }},
+        {"BottomUpMergeSort", bottom_up_merge_sort},
+        {"NaturalMergeSort", natural_merge_sort},
+        {"InPlaceMergeSort", in_place_merge_sort},
+        {"IntroSort", intro_sort<int>},
+        {"BlockQuickSort", block_quick_sort},
+        // Selection at the same block sizes, for comparison with full sorts
+        {"SelectMedian", [](vector<int>& arr, int low, int high) { nth_select(arr, low, high, low + (high - low) / 2); }},
+        {"PartialSortTop1%", [](vector<int>& arr, int low, int high) { partial_sort_k(arr, low, high, max(1, (high - low + 1) / 100)); }},
+        {"HeapTopK1%", [](vector<int>& arr, int low, int high) { heap_top_k(arr, low, high, max(1, (high - low + 1) / 100)); }},
+        {"RadixSort", [](vector<int>& arr, int low, int high) { radix_sort(arr, low, high); }},
+        {"AdaptiveSort", [&adaptive_decision](vector<int>& arr, int low, int high) { adaptive_decision = adaptive_sort(arr, low, high); }},
+    };
+    const char* case_names[] = {"Random", "Best", "Worst"};
+
+    file << fixed << setprecision(6);
+    file << "Block Size,Threads";
+    for (const auto& engine : engines)
+        for (const char* case_name : case_names) {
+            write_stats_header(file, engine.name + " " + case_name);
+            write_counters_header(file, engine.name + " " + case_name);
+        }
+    for (const auto& engine : engines)
+        file << "," << engine.name << " Allocs";
+    for (const auto& engine : engines)
+        file << "," << engine.name << " Peak Heap (bytes)";
+    file << "\n";
+
+    ofstream decisions(DECISION_LOG_FILE);
+    decisions << setprecision(4);
+    write_decision_header(decisions);
+
+    BenchConfig config = bench_default_config();
+    if (bench_pin_to_cpu(0) != 0)
+        cerr << "CPU pinning unavailable, timings may be noisier" << endl;
+    PerfCounters counters;
+    bench_enable_counters(&config, &counters);
 
     for (int block_size = 100; block_size <= NUM_COUNT; block_size += 100) {
-        vector<int> arr1, arr2;
-        read_numbers(arr1, block_size);
-        arr2 = arr1;
+        // Random input, best case (already sorted) and worst case (reversed)
+        vector<int> inputs[3];
+        read_numbers(numbers, inputs[0], block_size);
+        inputs[1] = inputs[0];
+        sort(inputs[1].begin(), inputs[1].end());
+        inputs[2] = inputs[1];
+        reverse(inputs[2].begin(), inputs[2].end());
 
-        auto start = high_resolution_clock::now();
-        quick_sort(arr1, 0, block_size - 1);
-        auto end = high_resolution_clock::now();
-        double quicksort_random = duration<double, milli>(end - start).count();
+        file << block_size << "," << pool.size();
+        cout << "Block Size: " << block_size;
+        vector<int> work;
+        for (const auto& engine : engines) {
+            for (int c = 0; c < 3; c++) {
+                BenchStats stats = bench(config,
+                    [&] { work = inputs[c]; },
+                    [&] { engine.sort(work, 0, block_size - 1); });
+                write_stats(file, stats);
+                write_counters(file, stats.counters);
+                cout << " | " << engine.name << " " << case_names[c] << ": " << stats.median_ms << " ms";
+                if (engine.name == "AdaptiveSort")
+                    write_decision(decisions, block_size, case_names[c], adaptive_decision);
+            }
+        }
+        for (const auto& engine : engines) {
+            work = inputs[0];
+            file << "," << count_allocations([&] { engine.sort(work, 0, block_size - 1); });
+        }
+        for (const auto& engine : engines) {
+            work = inputs[0];
+            file << "," << peak_heap_bytes([&] { engine.sort(work, 0, block_size - 1); });
+        }
+        file << "\n";
+        cout << endl;
+    }
+    perf_counters_close(&counters);
+    file.close();
+    dataset_close(&dataset);
+}
 
-        start = high_resolution_clock::now();
-        merge_sort(arr2, 0, block_size - 1);
-        end = high_resolution_clock::now();
-        double mergesort_random = duration<double, milli>(end - start).count();
+// Times quick_sort and merge_sort on the random input with every network
+// cutoff, 0 being the plain recursion down to single elements.
+void perform_network_sweep() {
+    Dataset dataset;
+    if (dataset_open(OUTPUT_FILE, &dataset) != 0 || dataset_int32(&dataset) == NULL || dataset.header.count < NUM_COUNT) {
+        cerr << "Error opening " << OUTPUT_FILE << " for reading!" << endl;
+        return;
+    }
+    const int32_t* numbers = dataset_int32(&dataset);
 
-        sort(arr1.begin(), arr1.end()); // Best case sorted input
-        start = high_resolution_clock::now();
-        quick_sort(arr1, 0, block_size - 1);
-        end = high_resolution_clock::now();
-        double quicksort_best = duration<double, milli>(end - start).count();
+    ofstream file(NETWORK_RESULT_FILE);
+    if (!file) {
+        cerr << "Error opening file for writing results!" << endl;
+        dataset_close(&dataset);
+        return;
+    }
+    file << fixed << setprecision(6);
+    file << "Block Size,Cutoff,Network";
+    write_stats_header(file, "QuickSort");
+    write_stats_header(file, "MergeSort");
+    file << "\n";
 
-        start = high_resolution_clock::now();
-        merge_sort(arr2, 0, block_size - 1);
-        end = high_resolution_clock::now();
-        double mergesort_best = duration<double, milli>(end - start).count();
+    BenchConfig config = bench_default_config();
+    bench_pin_to_cpu(0);
+    const int cutoffs[] = {0, 8, 16, 32, 64};
+    for (int block_size : {1000, 10000, NUM_COUNT}) {
+        vector<int> input, work;
+        read_numbers(numbers, input, block_size);
+        for (int cutoff : cutoffs) {
+            BenchStats quick = bench(config, [&] { work = input; }, [&] { quick_sort(work, 0, block_size - 1, cutoff); });
+            BenchStats merge = bench(config, [&] { work = input; }, [&] { merge_sort(work, 0, block_size - 1, cutoff); });
+            file << block_size << "," << cutoff << "," << NETWORK_ISA;
+            write_stats(file, quick);
+            write_stats(file, merge);
+            file << "\n";
+            cout << "Block Size: " << block_size << " | Cutoff: " << cutoff << " | QuickSort: " << quick.median_ms
+                 << " ms | MergeSort: " << merge.median_ms << " ms" << endl;
+        }
+    }
+    file.close();
+    dataset_close(&dataset);
+    cout << "Network cutoff sweep complete (" << NETWORK_ISA << "). Results saved in " << NETWORK_RESULT_FILE << "." << endl;
+}
 
-        sort(arr1.rbegin(), arr1.rend()); // Worst case reversed input
-        start = high_resolution_clock::now();
-        quick_sort(arr1, 0, block_size - 1);
-        end = high_resolution_clock::now();
-        double quicksort_worst = duration<double, milli>(end - start).count();
+// Times the merge step alone: the two sorted halves merge_sort would merge
+// at the top level of the random, best (sorted) and worst (reversed) case,
+// merged by the branchy loop merge() used to have, by branchless_merge and
+// by network_merge.
+void perform_merge_sweep() {
+    Dataset dataset;
+    if (dataset_open(OUTPUT_FILE, &dataset) != 0 || dataset_int32(&dataset) == NULL || dataset.header.count < NUM_COUNT) {
+        cerr << "Error opening " << OUTPUT_FILE << " for reading!" << endl;
+        return;
+    }
+    const int32_t* numbers = dataset_int32(&dataset);
 
-        start = high_resolution_clock::now();
-        merge_sort(arr2, 0, block_size - 1);
-        end = high_resolution_clock::now();
-        double mergesort_worst = duration<double, milli>(end - start).count();
+    ofstream file(MERGE_RESULT_FILE);
+    if (!file) {
+        cerr << "Error opening file for writing results!" << endl;
+        dataset_close(&dataset);
+        return;
+    }
+
+    auto branchy_merge = [](const int* a, int na, const int* b, int nb, int* out) {
+        int i = 0, j = 0, k = 0;
+        while (i < na && j < nb)
+            out[k++] = (a[i] <= b[j]) ? a[i++] : b[j++];
+        while (i < na) out[k++] = a[i++];
+        while (j < nb) out[k++] = b[j++];
+    };
+    struct MergeKernel {
+        string name;
+        function<void(const int*, int, const int*, int, int*)> merge;
+    };
+    vector<MergeKernel> kernels = {
+        {"BranchyMerge", branchy_merge},
+        {"BranchlessMerge", branchless_merge},
+        {"NetworkMerge", network_merge},
+    };
+    const char* case_names[] = {"Random", "Best", "Worst"};
+
+    file << fixed << setprecision(6);
+    file << "Block Size,Network";
+    for (const char* case_name : case_names)
+        for (const auto& kernel : kernels)
+            write_stats_header(file, kernel.name + " " + case_name);
+    file << "\n";
+
+    BenchConfig config = bench_default_config();
+    bench_pin_to_cpu(0);
+    for (int block_size = 1000; block_size <= NUM_COUNT; block_size += 1000) {
+        vector<int> inputs[3];
+        read_numbers(numbers, inputs[0], block_size);
+        inputs[1] = inputs[0];
+        sort(inputs[1].begin(), inputs[1].end());
+        inputs[2] = inputs[1];
+        reverse(inputs[2].begin(), inputs[2].end());
+
+        int half = block_size / 2;
+        file << block_size << "," << NETWORK_ISA;
+        cout << "Block Size: " << block_size;
+        vector<int> out(block_size);
+        for (int c = 0; c < 3; c++) {
+            vector<int>& input = inputs[c];
+            sort(input.begin(), input.begin() + half);
+            sort(input.begin() + half, input.end());
+            for (const auto& kernel : kernels) {
+                BenchStats stats = bench(config, [] {},
+                    [&] { kernel.merge(input.data(), half, input.data() + half, block_size - half, out.data()); });
+                write_stats(file, stats);
+                cout << " | " << kernel.name << " " << case_names[c] << ": " << stats.median_ms << " ms";
+            }
+        }
+        file << "\n";
+        cout << endl;
+    }
+    file.close();
+    dataset_close(&dataset);
+    cout << "Merge kernel benchmark complete (" << NETWORK_ISA << "). Results saved in " << MERGE_RESULT_FILE << "." << endl;
+}
+
+// Times sample_sort and parallel_merge_sort on `count` generated elements
+// (not the dataset file, so 10^8-10^9 elements need no disk space) with
+// 1, 2, 4, ... max_threads threads. Needs about 13 bytes per element.
+void perform_scaling(long long count, unsigned max_threads) {
+    if (count < 1 || count > INT_MAX) {
+        cerr << "Element count must be between 1 and " << INT_MAX << "!" << endl;
+        return;
+    }
+    ofstream file(SCALING_RESULT_FILE);
+    if (!file) {
+        cerr << "Error opening file for writing results!" << endl;
+        return;
+    }
+    file << fixed << setprecision(6);
+    file << "Elements,Threads";
+    write_stats_header(file, "SampleSort");
+    write_stats_header(file, "ParallelMergeSort");
+    file << "\n";
+
+    WorkloadSpec spec = workload_from_env(WORKLOAD_UNIFORM, time(nullptr), count, 0, INT_MAX);
+    vector<int> input(count), work;
+    workload_fill(&spec, input.data(), max(max_threads, 1u));
+    cout << "Generated " << count << " " << workload_names[spec.dist] << " numbers with seed " << spec.seed << endl;
+
+    BenchConfig config = bench_default_config();
+    vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max(max_threads, 1u));
+    for (unsigned threads : thread_counts) {
+        WorkStealingPool pool(threads);
+        BenchStats sample = bench(config, [&] { work = input; }, [&] { sample_sort(work, 0, count - 1, pool); });
+        BenchStats merge = bench(config, [&] { work = input; }, [&] { parallel_merge_sort(work, 0, count - 1, pool); });
+        file << count << "," << threads;
+        write_stats(file, sample);
+        write_stats(file, merge);
+        file << "\n";
+        cout << "Threads: " << threads << " | SampleSort: " << sample.median_ms << " ms | ParallelMergeSort: " << merge.median_ms << " ms" << endl;
+    }
+    file.close();
+    cout << "Scaling benchmark complete. Results saved in " << SCALING_RESULT_FILE << "." << endl;
+}
 
-        file << block_size << "," << quicksort_random << "," << mergesort_random << "," << quicksort_best << "," << mergesort_best << "," << quicksort_worst << "," << mergesort_worst << "\n";
+template<size_t Bytes>
+void measure_payload_sorts(ofstream& file, const BenchConfig& config, const int32_t* numbers, int block_size) {
+    vector<int> keys, work_keys;
+    read_numbers(numbers, keys, block_size);
+    vector<Payload<Bytes>> payloads(block_size), work_payloads;
+    vector<Record<Bytes>> records(block_size), work_records;
+    for (int i = 0; i < block_size; i++) {
+        memset(payloads[i].bytes, i & 0xFF, Bytes);
+        records[i] = {keys[i], payloads[i]};
+    }
+
+    vector<int> order;
+    BenchStats stats[5] = {
+        bench(config, [&] { work_records = records; }, [&] { intro_sort(work_records, 0, block_size - 1); }),
+        bench(config, [&] { work_keys = keys; work_payloads = payloads; }, [&] { sort_records(work_keys, work_payloads, SortBackend::Comparison); }),
+        bench(config, [&] { work_keys = keys; work_payloads = payloads; }, [&] { sort_records(work_keys, work_payloads, SortBackend::Radix); }),
+        bench(config, [] {}, [&] { order = argsort(keys, SortBackend::Comparison); }),
+        bench(config, [] {}, [&] { order = argsort(keys, SortBackend::Radix); }),
+    };
+    file << block_size << "," << Bytes;
+    cout << "Block Size: " << block_size << " | Payload: " << Bytes << " bytes";
+    for (const BenchStats& s : stats) {
+        write_stats(file, s);
+        cout << " | " << s.median_ms << " ms";
+    }
+    file << "\n";
+    cout << endl;
+}
+
+// Sorts keys that carry 8, 16 and 64-byte payloads as an array of records
+// (payloads move on every swap), as key/payload arrays through argsort
+// (payloads move once), and times the argsorts alone.
+void perform_payload_experiment() {
+    Dataset dataset;
+    if (dataset_open(OUTPUT_FILE, &dataset) != 0 || dataset_int32(&dataset) == NULL || dataset.header.count < NUM_COUNT) {
+        cerr << "Error opening " << OUTPUT_FILE << " for reading!" << endl;
+        return;
+    }
+    const int32_t* numbers = dataset_int32(&dataset);
+
+    ofstream file(PAYLOAD_RESULT_FILE);
+    if (!file) {
+        cerr << "Error opening file for writing results!" << endl;
+        dataset_close(&dataset);
+        return;
+    }
+    file << fixed << setprecision(6);
+    file << "Block Size,Payload Bytes";
+    for (const char* name : {"RecordIntroSort", "KeyPayloadIntroSort", "KeyPayloadRadixSort", "ArgsortIntroSort", "ArgsortRadixSort"})
+        write_stats_header(file, name);
+    file << "\n";
 
-        cout << "Block Size: " << block_size << " | QuickSort Random: " << quicksort_random << " ms | MergeSort Random: " << mergesort_random
-            << " ms | QuickSort Best: " << quicksort_best << " ms | MergeSort Best: " << mergesort_best
-            << " ms | QuickSort Worst: " << quicksort_worst << " ms | MergeSort Worst: " << mergesort_worst << " ms" << endl;
+    BenchConfig config = bench_default_config();
+    bench_pin_to_cpu(0);
+    for (int block_size = 10000; block_size <= NUM_COUNT; block_size += 10000) {
+        measure_payload_sorts<8>(file, config, numbers, block_size);
+        measure_payload_sorts<16>(file, config, numbers, block_size);
+        measure_payload_sorts<64>(file, config, numbers, block_size);
     }
     file.close();
+    dataset_close(&dataset);
+    cout << "Payload experiment complete. Results saved in " << PAYLOAD_RESULT_FILE << "." << endl;
 }
 
-int main() {
-    srand(time(nullptr));
-    generate_random_numbers();
-    perform_experiment();
-    cout << "Experiment complete. Results saved in " << TIME_RESULT_FILE << "." << endl;
+// Usage: ./a.out [threads]  (defaults to all hardware threads)
+//        ./a.out payload
+//        ./a.out scaling [count] [max_threads]  (defaults to 10^8 and all hardware threads)
+//        ./a.out network
+//        ./a.out merge
+//        ./a.out external <input.bin> <output.bin> [run_size] [fan_in]
+//        ./a.out topk <input.bin> <k>
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "topk") {
+        if (argc < 4) {
+            cerr << "Usage: " << argv[0] << " topk <input.bin> <k>" << endl;
+            return 1;
+        }
+        perform_top_k(argv[2], atoi(argv[3]));
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "external") {
+        if (argc < 4) {
+            cerr << "Usage: " << argv[0] << " external <input.bin> <output.bin> [run_size] [fan_in]" << endl;
+            return 1;
+        }
+        long long run_size = (argc > 4) ? atoll(argv[4]) : EXTERNAL_RUN_SIZE;
+        int fan_in = (argc > 5) ? atoi(argv[5]) : EXTERNAL_FAN_IN;
+        perform_external_sort(argv[2], argv[3], run_size, fan_in);
+        return 0;
+    }
+
+    if (argc > 1 && string(argv[1]) == "network") {
+        generate_random_numbers(time(nullptr), max(thread::hardware_concurrency(), 1u));
+        perform_network_sweep();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "scaling") {
+        long long count = (argc > 2) ? atoll(argv[2]) : 100000000;
+        unsigned max_threads = (argc > 3) ? atoi(argv[3]) : thread::hardware_concurrency();
+        perform_scaling(count, max_threads);
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "payload") {
+        generate_random_numbers(time(nullptr), max(thread::hardware_concurrency(), 1u));
+        perform_payload_experiment();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "merge") {
+        generate_random_numbers(time(nullptr), max(thread::hardware_concurrency(), 1u));
+        perform_merge_sweep();
+        return 0;
+    }
+
+    unsigned threads = (argc > 1) ? atoi(argv[1]) : thread::hardware_concurrency();
+    WorkStealingPool pool(threads);
+
+    generate_random_numbers(time(nullptr), max(threads, 1u));
+    perform_experiment(pool);
+    cout << "Experiment complete. Results saved in " << TIME_RESULT_FILE << ", adaptive_sort decisions in " << DECISION_LOG_FILE << "." << endl;
     return 0;
 }
@@ -1,4 +1,9 @@
 #include <bits/stdc++.h>
+#include "../common/work_stealing_pool.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 using namespace std;
 using namespace chrono;
@@ -19,17 +24,21 @@ struct pt {
 
 // Orientation: 0 (COLL), 1 (CW), -1 (CCW)
 int orientation(pt a, pt b, pt c) {
-    int val = (b.y - a.y) * (c.x - b.x) - (b.x - a.x) * (c.y - b.y);
+    long long val = (long long)(b.y - a.y) * (c.x - b.x) - (long long)(b.x - a.x) * (c.y - b.y);
     if (val == 0) return 0;
     return (val > 0) ? 1 : -1;
 }
 
-int distance(pt a, pt b) {
-    return (a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y);
+long long distance(pt a, pt b) {
+    return (long long)(a.x - b.x) * (a.x - b.x) + (long long)(a.y - b.y) * (a.y - b.y);
+}
+
+// Cross product of (b - a) and (c - a): > 0 for a left (CCW) turn
+long long cross(pt a, pt b, pt c) {
+    return (long long)(b.x - a.x) * (c.y - a.y) - (long long)(b.y - a.y) * (c.x - a.x);
 }
 
-pt anchor;
-bool polarOrderCompare(pt a, pt b) {
+bool polarOrderCompare(pt anchor, pt a, pt b) {
     int o = orientation(anchor, a, b);
     if (o == 0) return (distance(anchor, a) < distance(anchor, b));
     return o == -1;
@@ -64,9 +73,10 @@ vector<pt> bruteForce(vector<pt>& pts) {
 }
 
 // Graham's Scan Algorithm
-vector<pt> grahamScanConvexHull(vector<pt>& pts) {
-    int n = pts.size();
-    if (n < 3) return {};
+// Works in place on pts[0..n): the hull ends up in pts[0..size) and its
+// size is returned (0 for fewer than 3 points).
+int grahamScanRange(pt* pts, int n) {
+    if (n < 3) return 0;
 
     // Find the anchor point (lowest y-coordinate)
     int minIdx = 0;
@@ -76,26 +86,92 @@ vector<pt> grahamScanConvexHull(vector<pt>& pts) {
         }
     }
     swap(pts[0], pts[minIdx]);
-    anchor = pts[0];
+    pt anchor = pts[0];
 
     // Sort points by polar angle
-    sort(pts.begin() + 1, pts.end(), polarOrderCompare);
+    sort(pts + 1, pts + n, [anchor](pt a, pt b) { return polarOrderCompare(anchor, a, b); });
 
-    // Build the convex hull
-    vector<pt> hull;
-    for (auto p : pts) {
-        while (hull.size() > 1 && orientation(hull[hull.size() - 2], hull.back(), p) != -1) {
-            hull.pop_back();
+    // Build the convex hull as a stack over the already scanned prefix
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        pt p = pts[i];
+        while (k > 1 && orientation(pts[k - 2], pts[k - 1], p) != -1) {
+            k--;
         }
-        hull.push_back(p);
+        pts[k++] = p;
+    }
+    return k;
+}
+
+vector<pt> grahamScanConvexHull(vector<pt>& pts) {
+    int k = grahamScanRange(pts.data(), pts.size());
+    return vector<pt>(pts.begin(), pts.begin() + k);
+}
+
+// Andrew's Monotone Chain Algorithm
+// Needs only a lexicographic sort and no shared state, so independent calls
+// can run concurrently. Collinear points on the boundary are dropped; the
+// hull comes back counterclockwise from the lowest-leftmost point.
+vector<pt> monotoneChainConvexHull(vector<pt>& pts) {
+    sort(pts.begin(), pts.end());
+    pts.erase(unique(pts.begin(), pts.end()), pts.end());
+    int n = pts.size();
+    if (n < 3) return pts;
+
+    vector<pt> hull(2 * n);
+    int k = 0;
+    // Lower chain, left to right
+    for (int i = 0; i < n; i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
+    }
+    // Upper chain, right to left
+    for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], pts[i]) <= 0) k--;
+        hull[k++] = pts[i];
     }
+    hull.resize(k - 1); // the last point repeats the first
     return hull;
 }
 
 // Divide and Conquer Algorithm
-void mergeHulls(vector<pt>& leftHull, vector<pt>& rightHull, vector<pt>& mergedHull) {
-    int n1 = leftHull.size(), n2 = rightHull.size();
+// Hulls are kept counterclockwise. The points are sorted once; the hull of
+// the sorted range pts[lo..hi) is built in hull[lo..hi), a workspace as long
+// as the input, so no level allocates or copies its halves.
+#define DC_BASE_CASE 32          // ranges up to this size are finished by a monotone chain
+#define DC_PARALLEL_CUTOFF 32768 // smaller ranges are not split into parallel tasks
+
+// Monotone chain over the already sorted pts[0..n) into out (room for n + 1).
+int chainHull(const pt* pts, int n, pt* out) {
+    if (n == 1) {
+        out[0] = pts[0];
+        return 1;
+    }
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        while (k >= 2 && cross(out[k - 2], out[k - 1], pts[i]) <= 0) k--;
+        out[k++] = pts[i];
+    }
+    for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+        while (k >= lower && cross(out[k - 2], out[k - 1], pts[i]) <= 0) k--;
+        out[k++] = pts[i];
+    }
+    return k - 1;
+}
+
+// True if the tangent from `from` should move from `cur` on to `next`:
+// `next` lies beyond the line (on the side given by `side`), or on it and
+// farther away, so collinear points never end up inside a merged edge.
+bool tangentAdvances(pt from, pt cur, pt next, int side) {
+    long long c = cross(from, cur, next) * side;
+    return c > 0 || (c == 0 && distance(from, next) > distance(from, cur));
+}
 
+// Merges two hulls separated by a vertical line (every x in leftHull is
+// smaller than every x in rightHull) that lie back to back in memory:
+// rightHull starts at or after leftHull + n1. The merged hull is written
+// over leftHull and its size returned.
+int mergeHulls(pt* leftHull, int n1, pt* rightHull, int n2) {
     int rightmost_leftHull = 0;
     for (int i = 1; i < n1; i++) {
         if (leftHull[i].x > leftHull[rightmost_leftHull].x)
@@ -108,68 +184,502 @@ void mergeHulls(vector<pt>& leftHull, vector<pt>& rightHull, vector<pt>& mergedH
             leftmost_rightHull = i;
     }
 
-    // Find the upper tangent
+    // Find the upper tangent: counterclockwise on the left hull, clockwise on the right
     int upperLeft = rightmost_leftHull, upperRight = leftmost_rightHull;
     bool done = false;
     while (!done) {
         done = true;
-        while (orientation(rightHull[upperRight], leftHull[upperLeft], leftHull[(upperLeft + 1) % n1]) == -1) {
+        while (tangentAdvances(rightHull[upperRight], leftHull[upperLeft], leftHull[(upperLeft + 1) % n1], -1)) {
             upperLeft = (upperLeft + 1) % n1;
         }
-        while (orientation(leftHull[upperLeft], rightHull[upperRight], rightHull[(n2 + upperRight - 1) % n2]) == 1) {
+        while (tangentAdvances(leftHull[upperLeft], rightHull[upperRight], rightHull[(n2 + upperRight - 1) % n2], 1)) {
             upperRight = (n2 + upperRight - 1) % n2;
             done = false;
         }
     }
 
-    // Find the lower tangent
+    // Find the lower tangent: clockwise on the left hull, counterclockwise on the right
     int lowerLeft = rightmost_leftHull, lowerRight = leftmost_rightHull;
     done = false;
     while (!done) {
         done = true;
-        while (orientation(leftHull[lowerLeft], rightHull[lowerRight], rightHull[(lowerRight + 1) % n2]) == -1) {
-            lowerRight = (lowerRight + 1) % n2;
-        }
-        while (orientation(rightHull[lowerRight], leftHull[lowerLeft], leftHull[(n1 + lowerLeft - 1) % n1]) == 1) {
+        while (tangentAdvances(rightHull[lowerRight], leftHull[lowerLeft], leftHull[(n1 + lowerLeft - 1) % n1], 1)) {
             lowerLeft = (n1 + lowerLeft - 1) % n1;
+        }
+        while (tangentAdvances(leftHull[lowerLeft], rightHull[lowerRight], rightHull[(lowerRight + 1) % n2], -1)) {
+            lowerRight = (lowerRight + 1) % n2;
             done = false;
         }
     }
 
-    // Merge the hulls
-    mergedHull.clear();
-    for (int i = 0; i <= upperLeft; i++) {
-        mergedHull.push_back(leftHull[i]);
+    // Merge the hulls: leftHull from upperLeft round to lowerLeft, then
+    // rightHull from lowerRight round to upperRight. Rotating each hull to
+    // start at its first kept point turns both arcs into prefixes.
+    rotate(leftHull, leftHull + upperLeft, leftHull + n1);
+    rotate(rightHull, rightHull + lowerRight, rightHull + n2);
+    int keptLeft = (lowerLeft - upperLeft + n1) % n1 + 1;
+    int keptRight = (upperRight - lowerRight + n2) % n2 + 1;
+    if (leftHull + keptLeft != rightHull)
+        copy(rightHull, rightHull + keptRight, leftHull + keptLeft);
+    return keptLeft + keptRight;
+}
+
+int divideAndConquerRange(const pt* pts, pt* hull, int lo, int hi, WorkStealingPool* pool) {
+    int n = hi - lo;
+    if (pts[lo].x == pts[hi - 1].x) {
+        // One vertical line: the hull is its two ends
+        hull[lo] = pts[lo];
+        if (pts[lo] == pts[hi - 1]) return 1;
+        hull[lo + 1] = pts[hi - 1];
+        return 2;
     }
-    for (int i = upperRight; i != (lowerRight + 1) % n2; i = (i + 1) % n2) {
-        mergedHull.push_back(rightHull[i]);
+    if (n <= DC_BASE_CASE) {
+        pt buffer[DC_BASE_CASE + 1];
+        int size = chainHull(pts + lo, n, buffer);
+        copy(buffer, buffer + size, hull + lo);
+        return size;
     }
-    for (int i = (lowerLeft + 1) % n1; i != 0; i = (i + 1) % n1) {
-        mergedHull.push_back(leftHull[i]);
+
+    // Split between two different x values, as close to the middle as possible
+    int mid = lo + n / 2;
+    while (mid < hi && pts[mid].x == pts[mid - 1].x) mid++;
+    if (mid == hi) {
+        mid = lo + n / 2;
+        while (pts[mid].x == pts[mid - 1].x) mid--;
     }
+
+    int leftSize, rightSize;
+    if (pool != nullptr && n > DC_PARALLEL_CUTOFF) {
+        pool->fork_join(
+            [&] { leftSize = divideAndConquerRange(pts, hull, lo, mid, pool); },
+            [&] { rightSize = divideAndConquerRange(pts, hull, mid, hi, pool); });
+    } else {
+        leftSize = divideAndConquerRange(pts, hull, lo, mid, pool);
+        rightSize = divideAndConquerRange(pts, hull, mid, hi, pool);
+    }
+    return mergeHulls(hull + lo, leftSize, hull + mid, rightSize);
 }
 
-vector<pt> divideAndConquer(vector<pt> pts) {
-    int n = pts.size();
-    if (n <= 3) return bruteForce(pts);
+// Sorts pts[lo..hi) by splitting it into halves sorted as parallel tasks
+// and merging them back.
+void parallelSort(vector<pt>& pts, int lo, int hi, WorkStealingPool& pool) {
+    if (hi - lo <= DC_PARALLEL_CUTOFF) {
+        sort(pts.begin() + lo, pts.begin() + hi);
+        return;
+    }
+    int mid = lo + (hi - lo) / 2;
+    pool.fork_join(
+        [&] { parallelSort(pts, lo, mid, pool); },
+        [&] { parallelSort(pts, mid, hi, pool); });
+    inplace_merge(pts.begin() + lo, pts.begin() + mid, pts.begin() + hi);
+}
 
+vector<pt> divideAndConquer(vector<pt>& pts) {
+    if (pts.empty()) return {};
     sort(pts.begin(), pts.end());
+    vector<pt> hull(pts.size());
+    hull.resize(divideAndConquerRange(pts.data(), hull.data(), 0, pts.size(), nullptr));
+    return hull;
+}
 
-    vector<pt> leftHalf(pts.begin(), pts.begin() + n / 2);
-    vector<pt> rightHalf(pts.begin() + n / 2, pts.end());
+vector<pt> parallelDivideAndConquer(vector<pt>& pts, WorkStealingPool& pool) {
+    if (pts.empty()) return {};
+    parallelSort(pts, 0, pts.size(), pool);
+    vector<pt> hull(pts.size());
+    hull.resize(divideAndConquerRange(pts.data(), hull.data(), 0, pts.size(), &pool));
+    return hull;
+}
+
+// Chan's Algorithm
+// O(n log h): the points are split into groups of m, each group gets a
+// Graham scan mini-hull, and a Jarvis march wraps the mini-hulls, finding
+// the next vertex of each in O(log m) by binary search. If the march does
+// not close within m steps the hull has more than m vertices, so the
+// round is repeated with m squared. Returns the hull counterclockwise from
+// the leftmost point.
+#define CHAN_FIRST_GROUP 16 // the textbook m = 4 round rarely closes on large inputs and costs a full pass
+
+// Vertex q of the mini-hull hull[0..k) (counterclockwise, strictly convex,
+// k >= 3) such that the whole mini-hull lies left of p -> q, the farthest
+// one if several are collinear with p. p must not be strictly inside it.
+// Seen from p the vertices rise in angle from one tangent to the other and
+// fall back, so edge i -> i+1 "advances" (tangentAdvances) exactly on the
+// rising stretch, and q is where it stops. Whether a vertex lies past
+// hull[0] tells which side of that stretch it is on.
+int tangentIndex(const pt* hull, int k, pt p) {
+    auto advances = [&](int i) { return tangentAdvances(p, hull[i], hull[i + 1 < k ? i + 1 : 0], -1); };
+    auto pastFirst = [&](int i) { return tangentAdvances(p, hull[0], hull[i], -1); };
+
+    bool firstAdvances = advances(0);
+    int lo = 1, hi = k;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        bool rising = advances(mid);
+        bool beforeTangent = firstAdvances ? (rising && pastFirst(mid)) : (rising || !pastFirst(mid));
+        if (beforeTangent) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo % k;
+}
 
-    vector<pt> leftHull = divideAndConquer(leftHalf);
-    vector<pt> rightHull = divideAndConquer(rightHalf);
+// One round with groups of m points; false if the hull has more than m
+// vertices. miniHulls holds the previous round's (offset, size, convex)
+// mini-hulls in work, or is empty in the first round, when work is a copy
+// of the input. A point off the mini-hull of a smaller group cannot be on
+// the hull of a larger group containing it, so each new group runs Graham
+// only on the vertices of the mini-hulls it absorbs, gathered in place.
+bool chanRound(int n, int m, pt start, vector<pt>& work, vector<tuple<int, int, bool>>& miniHulls, vector<pt>& hull) {
+    vector<tuple<int, int, bool>> groups;
+    size_t absorbed = 0;
+    for (int i = 0; i < n; i += m) {
+        int len = 0;
+        if (miniHulls.empty()) {
+            len = min(m, n - i);
+        } else {
+            for (; absorbed < miniHulls.size() && get<0>(miniHulls[absorbed]) < i + m; absorbed++) {
+                auto [offset, size, convex] = miniHulls[absorbed];
+                if (offset != i + len) copy(work.begin() + offset, work.begin() + offset + size, work.begin() + i + len);
+                len += size;
+            }
+        }
+        // Fewer than 3 points are left as they are; a collinear group comes back as its two ends
+        int size = grahamScanRange(&work[i], len);
+        if (size == 0) size = len;
+        groups.emplace_back(i, size, size >= 3);
+    }
+    miniHulls.swap(groups);
+
+    hull.clear();
+    pt p = start;
+    for (int step = 0; step < m; step++) {
+        hull.push_back(p);
+        bool found = false;
+        pt next;
+        for (auto [offset, size, convex] : miniHulls) {
+            const pt* miniHull = &work[offset];
+            int first = 0, last = size;
+            if (convex) {
+                first = tangentIndex(miniHull, size, p);
+                last = first + 1;
+            }
+            for (int j = first; j < last; j++) {
+                pt q = miniHull[j];
+                if (!(q == p) && (!found || tangentAdvances(p, next, q, -1))) next = q, found = true;
+            }
+        }
+        if (!found || next == start) return true;
+        p = next;
+    }
+    return false;
+}
 
-    vector<pt> mergedHull;
-    mergeHulls(leftHull, rightHull, mergedHull);
-    return mergedHull;
+vector<pt> chanConvexHull(vector<pt>& pts) {
+    int n = pts.size();
+    if (n == 0) return {};
+    pt start = *min_element(pts.begin(), pts.end());
+    vector<pt> work = pts, hull;
+    vector<tuple<int, int, bool>> miniHulls;
+    for (long long m = CHAN_FIRST_GROUP;; m = m * m) {
+        if (chanRound(n, min<long long>(m, n), start, work, miniHulls, hull)) return hull;
+    }
 }
 
-vector<pt> generateRandomPoints(int n) {
+// QuickHull Algorithm
+// The leftmost and rightmost points split the rest into the points below
+// and above the line through them. For each side, the point farthest from
+// the current edge is a hull vertex; the points outside the two new edges
+// are kept and everything inside the triangle is dropped. Each split is one
+// pass that also finds the farthest point of both new candidate sets.
+// Large sets are split by chunks in parallel and the two sub-problems run
+// as parallel tasks. Returns the hull counterclockwise from the leftmost point.
+#define QH_PARALLEL_CUTOFF 32768 // smaller candidate sets are split and recursed on serially
+#define QH_MAX_CHUNKS 64
+
+struct QuickHullParts {
+    int count[2];
+    long long dist[2]; // cross product against the edge, twice the triangle area
+    pt farthest[2];
+};
+
+// True if x, at cross product d from edge a -> b, beats the current
+// farthest point. Ties go to the point farther along a -> b, so when several
+// points lie on the supporting line the chosen one is an end of it rather
+// than a collinear middle point.
+bool quickHullFarther(pt a, pt b, long long d, pt x, long long bestDist, pt best) {
+    if (d != bestDist) return d > bestDist;
+    long long ex = b.x - a.x, ey = b.y - a.y;
+    return ex * x.x + ey * x.y > ex * best.x + ey * best.y;
+}
+
+int quickHullChunks(int n, WorkStealingPool* pool) {
+    return (pool != nullptr && n > QH_PARALLEL_CUTOFF) ? min<int>(pool->size() * 4, QH_MAX_CHUNKS) : 1;
+}
+
+// Moves the points of pts[lo..hi) strictly left of a0 -> b0 to pts[lo..),
+// followed by those (of the rest) strictly left of a1 -> b1, and drops the
+// others. Each chunk writes its two parts to both ends of its slice of
+// scratch; they are then gathered back into pts.
+QuickHullParts quickHullSplit(pt* pts, pt* scratch, int lo, int hi, pt a0, pt b0, pt a1, pt b1, WorkStealingPool* pool) {
+    int n = hi - lo, chunks = quickHullChunks(n, pool);
+    QuickHullParts part[QH_MAX_CHUNKS];
+    auto bounds = [&](int c) { return lo + (int)((long long)n * c / chunks); };
+
+    auto classify = [&](int c) {
+        QuickHullParts& r = part[c];
+        r.dist[0] = r.dist[1] = 0;
+        int begin = bounds(c), end = bounds(c + 1), front = begin, back = end;
+        for (int i = begin; i < end; i++) {
+            pt x = pts[i];
+            long long d0 = cross(a0, b0, x), d1 = cross(a1, b1, x);
+            if (d0 > 0) {
+                scratch[front++] = x;
+                if (quickHullFarther(a0, b0, d0, x, r.dist[0], r.farthest[0])) r.dist[0] = d0, r.farthest[0] = x;
+            } else if (d1 > 0) {
+                scratch[--back] = x;
+                if (quickHullFarther(a1, b1, d1, x, r.dist[1], r.farthest[1])) r.dist[1] = d1, r.farthest[1] = x;
+            }
+        }
+        r.count[0] = front - begin;
+        r.count[1] = end - back;
+    };
+
+    QuickHullParts total = {{0, 0}, {0, 0}, {pt(), pt()}};
+    int offset[QH_MAX_CHUNKS][2];
+    auto gather = [&](int c) {
+        int begin = bounds(c), end = bounds(c + 1);
+        copy(scratch + begin, scratch + begin + part[c].count[0], pts + offset[c][0]);
+        copy(scratch + end - part[c].count[1], scratch + end, pts + offset[c][1]);
+    };
+
+    if (chunks == 1) {
+        classify(0);
+        total = part[0];
+        offset[0][0] = lo;
+        offset[0][1] = lo + total.count[0];
+        gather(0);
+        return total;
+    }
+
+    parallel_for(*pool, 0, chunks, classify);
+    for (int c = 0; c < chunks; c++) {
+        for (int s = 0; s < 2; s++) {
+            pt a = s ? a1 : a0, b = s ? b1 : b0;
+            total.count[s] += part[c].count[s];
+            if (part[c].count[s] > 0 && quickHullFarther(a, b, part[c].dist[s], part[c].farthest[s], total.dist[s], total.farthest[s]))
+                total.dist[s] = part[c].dist[s], total.farthest[s] = part[c].farthest[s];
+        }
+    }
+    for (int c = 0, at0 = lo, at1 = lo + total.count[0]; c < chunks; c++) {
+        offset[c][0] = at0, at0 += part[c].count[0];
+        offset[c][1] = at1, at1 += part[c].count[1];
+    }
+    parallel_for(*pool, 0, chunks, gather);
+    return total;
+}
+
+// Appends the hull vertices among pts[lo..hi), which all lie strictly left
+// of p -> q and of which f is the farthest, in counterclockwise order from
+// q to p.
+void quickHullRecurse(pt* pts, pt* scratch, int lo, int hi, pt p, pt q, pt f, vector<pt>& out, WorkStealingPool* pool) {
+    if (lo == hi) return;
+    QuickHullParts parts = quickHullSplit(pts, scratch, lo, hi, f, q, p, f, pool);
+    int mid = lo + parts.count[0];
+
+    if (pool != nullptr && hi - lo > QH_PARALLEL_CUTOFF) {
+        vector<pt> second;
+        pool->fork_join(
+            [&] { quickHullRecurse(pts, scratch, lo, mid, f, q, parts.farthest[0], out, pool); },
+            [&] { quickHullRecurse(pts, scratch, mid, mid + parts.count[1], p, f, parts.farthest[1], second, pool); });
+        out.push_back(f);
+        out.insert(out.end(), second.begin(), second.end());
+    } else {
+        quickHullRecurse(pts, scratch, lo, mid, f, q, parts.farthest[0], out, pool);
+        out.push_back(f);
+        quickHullRecurse(pts, scratch, mid, mid + parts.count[1], p, f, parts.farthest[1], out, pool);
+    }
+}
+
+vector<pt> quickHullRun(vector<pt>& pts, WorkStealingPool* pool) {
+    int n = pts.size();
+    if (n == 0) return {};
+
+    // Leftmost and rightmost points, per chunk in parallel
+    int chunks = quickHullChunks(n, pool);
+    pt lowest[QH_MAX_CHUNKS], highest[QH_MAX_CHUNKS];
+    auto extremes = [&](int c) {
+        int begin = (int)((long long)n * c / chunks), end = (int)((long long)n * (c + 1) / chunks);
+        lowest[c] = *min_element(pts.begin() + begin, pts.begin() + end);
+        highest[c] = *max_element(pts.begin() + begin, pts.begin() + end);
+    };
+    if (chunks == 1) extremes(0);
+    else parallel_for(*pool, 0, chunks, extremes);
+    pt a = *min_element(lowest, lowest + chunks), b = *max_element(highest, highest + chunks);
+    if (a == b) return {a};
+
+    vector<pt> scratch(n);
+    QuickHullParts parts = quickHullSplit(pts.data(), scratch.data(), 0, n, b, a, a, b, pool);
+    int mid = parts.count[0];
+
+    vector<pt> hull = {a}, upper;
+    if (pool != nullptr && n > QH_PARALLEL_CUTOFF) {
+        pool->fork_join(
+            [&] { quickHullRecurse(pts.data(), scratch.data(), 0, mid, b, a, parts.farthest[0], hull, pool); },
+            [&] { quickHullRecurse(pts.data(), scratch.data(), mid, mid + parts.count[1], a, b, parts.farthest[1], upper, pool); });
+    } else {
+        quickHullRecurse(pts.data(), scratch.data(), 0, mid, b, a, parts.farthest[0], hull, pool);
+        quickHullRecurse(pts.data(), scratch.data(), mid, mid + parts.count[1], a, b, parts.farthest[1], upper, pool);
+    }
+    hull.push_back(b);
+    hull.insert(hull.end(), upper.begin(), upper.end());
+    return hull;
+}
+
+vector<pt> quickHull(vector<pt>& pts) {
+    return quickHullRun(pts, nullptr);
+}
+
+vector<pt> parallelQuickHull(vector<pt>& pts, WorkStealingPool& pool) {
+    return quickHullRun(pts, &pool);
+}
+
+// Akl-Toussaint Heuristic
+// The points extreme in x, y, x + y and x - y span an octagon inside the
+// hull; every point strictly inside it is not a hull vertex and can be
+// dropped before any hull algorithm runs. With -mavx2 both passes are
+// vectorized: the extremes are found 8 points per instruction, and the
+// inside test (8 cross products per point, computed in doubles, exact while
+// coordinates stay below 2^25) runs 4 points per instruction.
+struct Octagon {
+    pt v[8]; // counterclockwise, consecutive duplicates removed
+    int n;
+};
+
+Octagon extremeOctagon(const vector<pt>& pts) {
+    // Support points in counterclockwise order of direction: min y,
+    // max x - y, max x, max x + y, max y, min x - y, min x, min x + y
+    pt e[8];
+    fill(e, e + 8, pts[0]);
+    int n = pts.size(), i = 0;
+#if defined(__AVX2__)
+    // Each lane keeps, per direction, the largest key it has seen (minima are
+    // taken as maxima of the negated key) and the index of the first point
+    // with it; the lanes are then reduced to the first point overall, so the
+    // result matches the scalar loop.
+    const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i best[8], at[8];
+    {
+        pt p = pts[0];
+        int key0[8] = {-p.y, p.x - p.y, p.x, p.x + p.y, p.y, p.y - p.x, -p.x, -p.x - p.y};
+        for (int d = 0; d < 8; d++) best[d] = _mm256_set1_epi32(key0[d]), at[d] = zero;
+    }
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for (; i + 8 <= n; i += 8) {
+        __m256i lo = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)&pts[i]), deinterleave);
+        __m256i hi = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)&pts[i + 4]), deinterleave);
+        __m256i x = _mm256_permute2x128_si256(lo, hi, 0x20);
+        __m256i y = _mm256_permute2x128_si256(lo, hi, 0x31);
+        __m256i sum = _mm256_add_epi32(x, y), diff = _mm256_sub_epi32(x, y);
+        __m256i key[8] = {_mm256_sub_epi32(zero, y), diff, x, sum, y, _mm256_sub_epi32(zero, diff),
+                          _mm256_sub_epi32(zero, x), _mm256_sub_epi32(zero, sum)};
+        for (int d = 0; d < 8; d++) {
+            __m256i greater = _mm256_cmpgt_epi32(key[d], best[d]);
+            best[d] = _mm256_max_epi32(best[d], key[d]);
+            at[d] = _mm256_blendv_epi8(at[d], index, greater);
+        }
+        index = _mm256_add_epi32(index, _mm256_set1_epi32(8));
+    }
+    for (int d = 0; d < 8; d++) {
+        alignas(32) int value[8], where[8];
+        _mm256_store_si256((__m256i*)value, best[d]);
+        _mm256_store_si256((__m256i*)where, at[d]);
+        int lane = 0;
+        for (int l = 1; l < 8; l++)
+            if (value[l] > value[lane] || (value[l] == value[lane] && where[l] < where[lane])) lane = l;
+        e[d] = pts[where[lane]];
+    }
+#endif
+    for (; i < n; i++) {
+        const pt& p = pts[i];
+        if (p.y < e[0].y) e[0] = p;
+        if (p.x - p.y > e[1].x - e[1].y) e[1] = p;
+        if (p.x > e[2].x) e[2] = p;
+        if (p.x + p.y > e[3].x + e[3].y) e[3] = p;
+        if (p.y > e[4].y) e[4] = p;
+        if (p.x - p.y < e[5].x - e[5].y) e[5] = p;
+        if (p.x < e[6].x) e[6] = p;
+        if (p.x + p.y < e[7].x + e[7].y) e[7] = p;
+    }
+
+    Octagon oct;
+    oct.n = 0;
+    for (int i = 0; i < 8; i++) {
+        if (oct.n == 0 || !(e[i] == oct.v[oct.n - 1])) oct.v[oct.n++] = e[i];
+    }
+    while (oct.n > 1 && oct.v[oct.n - 1] == oct.v[0]) oct.n--;
+    return oct;
+}
+
+// Keeps the points that are not strictly inside the octagon, in their
+// original order.
+vector<pt> aklToussaintFilter(const vector<pt>& pts) {
+    if (pts.size() < 8) return pts;
+    Octagon oct = extremeOctagon(pts);
+    if (oct.n < 3) return pts;
+
+    // Point p is strictly inside iff cross(a, b, p) = ex * (p.y - a.y) - ey * (p.x - a.x) > 0
+    // for every edge a -> b with e = b - a
+    double ax[8], ay[8], ex[8], ey[8];
+    for (int i = 0; i < oct.n; i++) {
+        pt a = oct.v[i], b = oct.v[(i + 1) % oct.n];
+        ax[i] = a.x, ay[i] = a.y, ex[i] = b.x - a.x, ey[i] = b.y - a.y;
+    }
+
+    int n = pts.size(), k = 0, i = 0;
+    vector<pt> kept(n);
+#if defined(__AVX2__)
+    const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    for (; i + 4 <= n; i += 4) {
+        __m256i xy = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)&pts[i]), deinterleave);
+        __m256d px = _mm256_cvtepi32_pd(_mm256_castsi256_si128(xy));
+        __m256d py = _mm256_cvtepi32_pd(_mm256_extracti128_si256(xy, 1));
+        __m256d inside = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        for (int j = 0; j < oct.n; j++) {
+            __m256d c = _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(ex[j]), _mm256_sub_pd(py, _mm256_set1_pd(ay[j]))),
+                                      _mm256_mul_pd(_mm256_set1_pd(ey[j]), _mm256_sub_pd(px, _mm256_set1_pd(ax[j]))));
+            inside = _mm256_and_pd(inside, _mm256_cmp_pd(c, _mm256_setzero_pd(), _CMP_GT_OQ));
+        }
+        int mask = _mm256_movemask_pd(inside);
+        for (int l = 0; l < 4; l++) {
+            kept[k] = pts[i + l];
+            k += !((mask >> l) & 1);
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        bool inside = true;
+        for (int j = 0; j < oct.n; j++)
+            inside &= ex[j] * (pts[i].y - ay[j]) - ey[j] * (pts[i].x - ax[j]) > 0;
+        kept[k] = pts[i];
+        k += !inside;
+    }
+    kept.resize(k);
+    return kept;
+}
+
+// Runs hull algorithm f on the points that survive aklToussaintFilter.
+template<typename Func>
+auto withAklToussaint(Func f) {
+    return [f](vector<pt>& pts) {
+        vector<pt> kept = aklToussaintFilter(pts);
+        return f(kept);
+    };
+}
+
+vector<pt> generateRandomPoints(int n, int range = 100) {
     random_device rd;
     mt19937 gen(rd());
-    uniform_int_distribution<> dis(0, 100);
+    uniform_int_distribution<> dis(0, range);
 
     vector<pt> points;
     points.reserve(n);
@@ -179,6 +689,47 @@ vector<pt> generateRandomPoints(int n) {
     return points;
 }
 
+enum class PointDistribution { UniformSquare, Disk, Circle, Gaussian };
+const char* const pointDistributionNames[] = {"uniform-square", "disk", "circle", "gaussian"};
+
+// n points with coordinates in [0, range]: uniform in the square, uniform
+// in the inscribed disk, on its boundary circle (rounded to the grid), or
+// normal around the centre with sigma = range / 6 (clamped).
+vector<pt> generatePoints(int n, PointDistribution dist, int range) {
+    random_device rd;
+    mt19937 gen(rd());
+    uniform_real_distribution<> unit(0, 1);
+    normal_distribution<> normal(0, 1);
+    double c = range / 2.0;
+
+    vector<pt> points;
+    points.reserve(n);
+    while ((int)points.size() < n) {
+        double x, y;
+        switch (dist) {
+        case PointDistribution::UniformSquare:
+            x = unit(gen) * range, y = unit(gen) * range;
+            break;
+        case PointDistribution::Disk:
+            x = unit(gen) * 2 - 1, y = unit(gen) * 2 - 1;
+            if (x * x + y * y > 1) continue;
+            x = c + x * c, y = c + y * c;
+            break;
+        case PointDistribution::Circle: {
+            double a = unit(gen) * 2 * M_PI;
+            x = c + cos(a) * c, y = c + sin(a) * c;
+            break;
+        }
+        default:
+            x = c + normal(gen) * range / 6, y = c + normal(gen) * range / 6;
+            x = min(max(x, 0.0), (double)range), y = min(max(y, 0.0), (double)range);
+            break;
+        }
+        points.emplace_back((int)llround(x), (int)llround(y));
+    }
+    return points;
+}
+
 void writePointsToFile(const string& filename, const vector<pt>& original, const vector<pt>& hull) {
     ofstream file(filename);
     if (!file) {
@@ -218,7 +769,7 @@ void performTimingAnalysis(const string& filename, const vector<pt>& points) {
     }
 
     file << fixed << setprecision(2);
-    file << "Points BruteForce(us) DivideConquer(us) GrahamScan(us)\n";
+    file << "Points HullSize BruteForce(us) DivideConquer(us) GrahamScan(us) MonotoneChain(us) Chan(us)\n";
 
     for (int n = 4; n <= 100; n++) {
         vector<pt> samplePoints(points.begin(), points.begin() + n);
@@ -226,16 +777,162 @@ void performTimingAnalysis(const string& filename, const vector<pt>& points) {
         double timeBF = measureTime(bruteForce, samplePoints);
         double timeDC = measureTime(divideAndConquer, samplePoints);
         double timeGS = measureTime(grahamScanConvexHull, samplePoints);
+        double timeMC = measureTime(monotoneChainConvexHull, samplePoints);
+        double timeCH = measureTime(chanConvexHull, samplePoints);
 
-        file << n << " " << timeBF << " " << timeDC << " " << timeGS << "\n";
+        vector<pt> copy = samplePoints;
+        int h = chanConvexHull(copy).size();
+        file << n << " " << h << " " << timeBF << " " << timeDC << " " << timeGS << " " << timeMC << " " << timeCH << "\n";
     }
 }
 
-int main() {
+// Times the hulls of `count` random points with coordinates up to 10^6:
+// the sequential algorithms once, the parallel divide and conquer with
+// 1, 2, 4, ... max_threads threads.
+void performLargeAnalysis(const string& filename, int count, unsigned max_threads) {
+    ofstream file(filename);
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return;
+    }
+
+    vector<pt> points = generateRandomPoints(count, 1000000);
+    double timeDC = measureTime(divideAndConquer, points, 1) / 1000;
+    double timeMC = measureTime(monotoneChainConvexHull, points, 1) / 1000;
+    double timeCH = measureTime(chanConvexHull, points, 1) / 1000;
+
+    vector<pt> sorted = points;
+    vector<pt> expected = monotoneChainConvexHull(sorted);
+    sort(expected.begin(), expected.end());
+
+    file << fixed << setprecision(2);
+    file << "Points HullSize Threads DivideConquer(ms) ParallelDivideConquer(ms) MonotoneChain(ms) Chan(ms)\n";
+    vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max(max_threads, 1u));
+    for (unsigned threads : thread_counts) {
+        WorkStealingPool pool(threads);
+        auto parallelDC = [&pool](vector<pt>& pts) { return parallelDivideAndConquer(pts, pool); };
+        double timePDC = measureTime(parallelDC, points, 1) / 1000;
+
+        vector<pt> copy = points;
+        vector<pt> hull = parallelDivideAndConquer(copy, pool);
+        sort(hull.begin(), hull.end());
+        if (hull != expected) cerr << "Parallel divide and conquer hull differs with " << threads << " threads!\n";
+
+        file << count << " " << expected.size() << " " << threads << " " << timeDC << " " << timePDC << " " << timeMC << " " << timeCH << "\n";
+        cout << "Threads: " << threads << " | DivideConquer: " << timeDC << " ms | ParallelDivideConquer: " << timePDC
+             << " ms | MonotoneChain: " << timeMC << " ms | Chan: " << timeCH << " ms (h = " << expected.size() << ")\n";
+    }
+}
+
+// For each distribution, the fraction of `count` points the Akl-Toussaint
+// filter drops and the end-to-end time of each algorithm with and without it.
+void performFilterAnalysis(const string& filename, int count) {
+    ofstream file(filename);
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return;
+    }
+
+    file << fixed << setprecision(2);
+    file << "Distribution Points Filtered(%)";
+    for (string name : {"GrahamScan", "MonotoneChain", "DivideConquer"})
+        file << " " << name << "(ms) " << name << "Filtered(ms) " << name << "Speedup";
+    file << "\n";
+
+    for (int d = 0; d < 4; d++) {
+        vector<pt> points = generatePoints(count, (PointDistribution)d, 1000000);
+        double filtered = 100.0 * (count - (int)aklToussaintFilter(points).size()) / count;
+        double times[6] = {
+            measureTime(grahamScanConvexHull, points, 3) / 1000,
+            measureTime(withAklToussaint(grahamScanConvexHull), points, 3) / 1000,
+            measureTime(monotoneChainConvexHull, points, 3) / 1000,
+            measureTime(withAklToussaint(monotoneChainConvexHull), points, 3) / 1000,
+            measureTime(divideAndConquer, points, 3) / 1000,
+            measureTime(withAklToussaint(divideAndConquer), points, 3) / 1000,
+        };
+
+        file << pointDistributionNames[d] << " " << count << " " << filtered;
+        cout << pointDistributionNames[d] << ": " << filtered << "% filtered";
+        for (int a = 0; a < 3; a++) {
+            double speedup = times[2 * a] / max(times[2 * a + 1], 0.001);
+            file << " " << times[2 * a] << " " << times[2 * a + 1] << " " << speedup;
+            cout << " | " << speedup << "x";
+        }
+        file << "\n";
+        cout << " (Graham, monotone chain, divide and conquer)\n";
+    }
+}
+
+// QuickHull against the other algorithms for each distribution at 10^2,
+// 10^3, ... max_count points. Brute force is only run up to 1000 points.
+void performQuickHullAnalysis(const string& filename, int max_count, unsigned threads) {
+    ofstream file(filename);
+    if (!file) {
+        cerr << "Error opening file: " << filename << endl;
+        return;
+    }
+
+    WorkStealingPool pool(threads);
+    auto parallelQH = [&pool](vector<pt>& pts) { return parallelQuickHull(pts, pool); };
+
+    file << fixed << setprecision(2);
+    file << "Distribution Points HullSize BruteForce(us) DivideConquer(us) GrahamScan(us) QuickHull(us) ParallelQuickHull(us)\n";
+    for (int d = 0; d < 4; d++) {
+        for (int n = 100; n <= max_count; n *= 10) {
+            vector<pt> points = generatePoints(n, (PointDistribution)d, 1000000);
+            int iterations = (n <= 1000) ? 20 : 3;
+
+            vector<pt> copy = points;
+            vector<pt> expected = monotoneChainConvexHull(copy);
+            copy = points;
+            if (parallelQuickHull(copy, pool) != expected) cerr << "QuickHull differs on " << pointDistributionNames[d] << "!\n";
+
+            file << pointDistributionNames[d] << " " << n << " " << expected.size() << " ";
+            if (n <= 1000) file << measureTime(bruteForce, points, iterations);
+            else file << "NA";
+            file << " " << measureTime(divideAndConquer, points, iterations)
+                 << " " << measureTime(grahamScanConvexHull, points, iterations)
+                 << " " << measureTime(quickHull, points, iterations)
+                 << " " << measureTime(parallelQH, points, iterations) << "\n";
+        }
+        cout << "QuickHull timings done for " << pointDistributionNames[d] << "\n";
+    }
+}
+
+// Usage: ./a.out                                  100 points, points.txt and timing.txt
+//        ./a.out large [count] [max_threads]      10^7 points by default, large_timing.txt
+//        ./a.out filter [count]                   10^6 points by default, filter_timing.txt
+//        ./a.out quickhull [max_count] [threads]  up to 10^6 points by default, quickhull_timing.txt
+// Build with -pthread (and -mavx2 for the vectorized filter).
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "large") {
+        int count = (argc > 2) ? atoi(argv[2]) : 10000000;
+        unsigned max_threads = (argc > 3) ? atoi(argv[3]) : max(thread::hardware_concurrency(), 1u);
+        performLargeAnalysis("large_timing.txt", count, max_threads);
+        cout << "Timing results written to large_timing.txt\n";
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "filter") {
+        int count = (argc > 2) ? atoi(argv[2]) : 1000000;
+        performFilterAnalysis("filter_timing.txt", count);
+        cout << "Timing results written to filter_timing.txt\n";
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "quickhull") {
+        int max_count = (argc > 2) ? atoi(argv[2]) : 1000000;
+        unsigned threads = (argc > 3) ? atoi(argv[3]) : max(thread::hardware_concurrency(), 1u);
+        performQuickHullAnalysis("quickhull_timing.txt", max_count, threads);
+        cout << "Timing results written to quickhull_timing.txt\n";
+        return 0;
+    }
+
     int NUM_POINTS = 100;
 
     vector<pt> points = generateRandomPoints(NUM_POINTS);
-    vector<pt> hull = grahamScanConvexHull(points);
+    vector<pt> scratch = points; // Graham's scan reorders and overwrites its input
+    vector<pt> hull = grahamScanConvexHull(scratch);
 
     writePointsToFile("points.txt", points, hull);
     performTimingAnalysis("timing.txt", points);
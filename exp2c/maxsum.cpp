@@ -1,42 +1,22 @@
 #include <bits/stdc++.h>
+#include "../common/workload.h"
 using namespace std;
 using namespace chrono;
 
 #define NUM_COUNT 10000
-#define OUTPUT_FILE "random_numbers.txt"
 #define TIME_RESULT_FILE "timing_results.txt"
 
 //block size 100 to 1000; incr by 100
 
-void generate_random_numbers() {
-    ofstream file(OUTPUT_FILE);
-    if (!file) {
-        cerr << "Error opening file for writing!" << endl;
-        return;
-    }
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<int> dist(-1000, 1000);
-
-    for (int i = 0; i < NUM_COUNT; i++) {
-        file << dist(gen) << endl;
-    }
-    file.close();
-}
-
-void read_numbers(vector<int>& arr, int size) {
-    ifstream file(OUTPUT_FILE);
-    if (!file)
-    {
-        cerr << "Error opening file for reading!" << endl;
-        return;
-    }
-    arr.resize(size);
-    for (int i = 0; i < size; i++)
-    {
-        file >> arr[i];
-    }
-    file.close();
+// Numbers in [-1000, 1000], generated in memory from a seeded workload
+// (uniform unless WORKLOAD_DIST / WORKLOAD_SEED override, see
+// common/workload.h) so every run can be reproduced from its seed.
+vector<int> generate_random_numbers(uint64_t seed) {
+    WorkloadSpec spec = workload_from_env(WORKLOAD_UNIFORM, seed, NUM_COUNT, -1000, 2001);
+    vector<int> numbers(NUM_COUNT);
+    workload_fill(&spec, numbers.data(), max(1u, thread::hardware_concurrency()));
+    cout << "Generated " << NUM_COUNT << " " << workload_names[spec.dist] << " numbers with seed " << spec.seed << endl;
+    return numbers;
 }
 
 int bruteForce(vector<int>& arr) {
@@ -128,7 +108,7 @@ int kadanesAlgo(vector<int>& arr) {
     return maxSum;
 }
 
-void performTimingAnalysis() {
+void performTimingAnalysis(const vector<int>& numbers) {
     ofstream file(TIME_RESULT_FILE);
     if (!file) {
         cerr << "Error opening time result file!" << endl;
@@ -137,8 +117,7 @@ void performTimingAnalysis() {
     file << "BlockSize\tBruteForce\tDivideandConquer\tKadane'sAlgorithm\n";
 
     for (int blockSize = 100; blockSize <= NUM_COUNT; blockSize += 100) {
-        vector<int> arr;
-        read_numbers(arr, blockSize);
+        vector<int> arr(numbers.begin(), numbers.begin() + blockSize);
 
         auto startBrute = high_resolution_clock::now();
         int bruteResult = bruteForce(arr);
@@ -163,9 +142,8 @@ void performTimingAnalysis() {
 }
 
 int main() {
-    generate_random_numbers();
-    cout << "Random nos. saved to " << OUTPUT_FILE << endl;
-    performTimingAnalysis();
+    vector<int> numbers = generate_random_numbers(time(nullptr));
+    performTimingAnalysis(numbers);
     cout << "Max sum & running times computed successfully and saved to " << TIME_RESULT_FILE << endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include <bits/stdc++.h>
+#include "../common/bench_timer.h"
+using namespace std;
+
+// Sorts the words of the big.txt corpus (the text rabinkarp.cpp samples its
+// inputs from) with two string sorts and std::sort.
+//
+// The corpus is read once into a single buffer, lowercased in place, and
+// every token is a string_view into that buffer, so no token gets its own
+// allocation and sorting only moves 16-byte views.
+//
+// Usage: ./a.out [corpus.txt]  (defaults to big.txt)
+
+#define CORPUS_FILE "big.txt"
+#define FALLBACK_CORPUS_FILE "input_10000.txt" // shipped with the repo, for a quick run without big.txt
+#define RESULT_FILE "string_sort_times.csv"
+#define STRING_INSERTION_CUTOFF 32 // buckets up to this size are finished by lcp_insertion_sort
+#define MSD_RADIX_CUTOFF 4096      // msd_radix_sort hands buckets up to this size to multikey_quicksort
+#define SWEEP_STEPS 10             // the benchmark sorts 10%, 20%, ... 100% of the tokens
+
+// Character at position `depth`, or -1 past the end, so shorter strings
+// sort first. Characters compare as unsigned, like string_view::compare.
+static inline int char_at(string_view s, int depth) {
+    return depth < (int)s.size() ? (unsigned char)s[depth] : -1;
+}
+
+// Number of characters s and t have in common from position `from` on.
+static inline int common_prefix(string_view s, string_view t, int from) {
+    int limit = min(s.size(), t.size()), i = from;
+    while (i < limit && s[i] == t[i]) i++;
+    return i - from;
+}
+
+// s < t, given that their first h characters are equal (and no more).
+static inline bool less_after(string_view s, string_view t, int h) {
+    return char_at(s, h) < char_at(t, h);
+}
+
+// Insertion sort of a[0..n), which all share their first `depth`
+// characters. Alongside the sorted prefix it keeps lcp[k], the common prefix
+// of a[k-1] and a[k], so while a string moves left most steps are decided
+// from the LCPs alone:
+//   lcp[j] > h: a[j-1] agrees with a[j] past the point where s < a[j], so s < a[j-1] too.
+//   lcp[j] < h: a[j-1] < a[j] at a position where s equals a[j], so a[j-1] < s.
+// Characters are only compared when lcp[j] == h, and then from h on.
+void lcp_insertion_sort(string_view* a, int n, int depth) {
+    int lcp[STRING_INSERTION_CUTOFF + 1];
+    for (int i = 1; i < n; i++) {
+        string_view s = a[i];
+        int j = i - 1;
+        int h = depth + common_prefix(s, a[j], depth); // LCP(s, a[j])
+        if (!less_after(s, a[j], h)) {
+            lcp[i] = h;
+            continue;
+        }
+        int left_lcp = -1; // LCP(a[j-1], s) once s stops at j
+        while (j > 0) {
+            if (lcp[j] > h) {
+                j--;
+            } else if (lcp[j] < h) {
+                left_lcp = lcp[j];
+                break;
+            } else {
+                int h2 = h + common_prefix(s, a[j - 1], h);
+                if (!less_after(s, a[j - 1], h2)) {
+                    left_lcp = h2;
+                    break;
+                }
+                h = h2;
+                j--;
+            }
+        }
+        move_backward(a + j, a + i, a + i + 1);
+        move_backward(lcp + j + 1, lcp + i, lcp + i + 1);
+        a[j] = s;
+        lcp[j + 1] = h;
+        if (j > 0) lcp[j] = left_lcp;
+    }
+}
+
+// Multikey quicksort (Bentley & Sedgewick): three-way partition on the
+// character at `depth`; the < and > parts are sorted at the same depth, the
+// = part moves on to the next character, so no character is compared twice
+// within a partition.
+void multikey_quicksort(string_view* a, int n, int depth) {
+    while (n > STRING_INSERTION_CUTOFF) {
+        int x = char_at(a[0], depth), y = char_at(a[n / 2], depth), z = char_at(a[n - 1], depth);
+        int pivot = max(min(x, y), min(max(x, y), z));
+
+        int lt = 0, gt = n - 1, i = 0;
+        while (i <= gt) {
+            int c = char_at(a[i], depth);
+            if (c < pivot) swap(a[lt++], a[i++]);
+            else if (c > pivot) swap(a[i], a[gt--]);
+            else i++;
+        }
+        multikey_quicksort(a, lt, depth);
+        multikey_quicksort(a + gt + 1, n - gt - 1, depth);
+        if (pivot < 0) return; // the = part is strings that all ended here, hence equal
+        a += lt;
+        n = gt - lt + 1;
+        depth++;
+    }
+    lcp_insertion_sort(a, n, depth);
+}
+
+// MSD radix sort: one counting pass over the character at `depth` (cached
+// in `oracle`), one distribution into temp and back, then every bucket but
+// the end-of-string one is sorted on the next character. temp and oracle
+// are scratch space of at least n entries, shared by all recursion levels.
+void msd_radix_sort(string_view* a, int n, int depth, string_view* temp, uint16_t* oracle) {
+    if (n <= MSD_RADIX_CUTOFF) {
+        multikey_quicksort(a, n, depth);
+        return;
+    }
+
+    size_t count[257] = {};
+    for (int i = 0; i < n; i++) {
+        oracle[i] = (uint16_t)(char_at(a[i], depth) + 1);
+        count[oracle[i]]++;
+    }
+    size_t start[258];
+    start[0] = 0;
+    for (int b = 0; b < 257; b++) start[b + 1] = start[b] + count[b];
+
+    size_t next[257];
+    copy(start, start + 257, next);
+    for (int i = 0; i < n; i++) temp[next[oracle[i]]++] = a[i];
+    copy(temp, temp + n, a);
+
+    for (int b = 1; b < 257; b++) {
+        int size = start[b + 1] - start[b];
+        if (size > 1) msd_radix_sort(a + start[b], size, depth + 1, temp, oracle);
+    }
+}
+
+void msd_radix_sort(vector<string_view>& tokens) {
+    vector<string_view> temp(tokens.size());
+    vector<uint16_t> oracle(tokens.size());
+    msd_radix_sort(tokens.data(), tokens.size(), 0, temp.data(), oracle.data());
+}
+
+// Lowercases `text` in place and returns a view of every maximal run of
+// letters and digits in it.
+vector<string_view> tokenize(string& text) {
+    vector<string_view> tokens;
+    size_t i = 0, n = text.size();
+    while (i < n) {
+        while (i < n && !isalnum((unsigned char)text[i])) i++;
+        size_t begin = i;
+        for (; i < n && isalnum((unsigned char)text[i]); i++) text[i] = tolower((unsigned char)text[i]);
+        if (i > begin) tokens.emplace_back(text.data() + begin, i - begin);
+    }
+    return tokens;
+}
+
+struct SortRun {
+    const vector<string_view>* input;
+    vector<string_view> work;
+    size_t count;
+    function<void(vector<string_view>&)> sort;
+};
+
+static void prepare_sort_run(void* ctx) {
+    SortRun* run = (SortRun*)ctx;
+    run->work.assign(run->input->begin(), run->input->begin() + run->count);
+}
+
+static void run_sort_run(void* ctx) {
+    SortRun* run = (SortRun*)ctx;
+    run->sort(run->work);
+}
+
+int main(int argc, char* argv[]) {
+    string path = (argc > 1) ? argv[1] : CORPUS_FILE;
+    ifstream corpus(path);
+    if (!corpus && argc <= 1) {
+        cerr << "Could not open " << path << ", falling back to " << FALLBACK_CORPUS_FILE << endl;
+        path = FALLBACK_CORPUS_FILE;
+        corpus.open(path);
+    }
+    if (!corpus) {
+        cerr << "Error opening " << path << "!" << endl;
+        return 1;
+    }
+
+    string text;
+    getline(corpus, text, '\0'); // Read entire corpus
+    corpus.close();
+    vector<string_view> tokens = tokenize(text);
+    if (tokens.empty()) {
+        cerr << "No tokens in " << path << "!" << endl;
+        return 1;
+    }
+    cout << "Read " << tokens.size() << " tokens (" << text.size() << " bytes) from " << path << endl;
+
+    vector<pair<string, function<void(vector<string_view>&)>>> engines = {
+        {"std::sort", [](vector<string_view>& v) { sort(v.begin(), v.end()); }},
+        {"MultikeyQuicksort", [](vector<string_view>& v) { multikey_quicksort(v.data(), v.size(), 0); }},
+        {"MsdRadixSort", [](vector<string_view>& v) { msd_radix_sort(v); }},
+    };
+
+    // Every engine must agree with std::sort before anything is timed.
+    vector<string_view> expected = tokens;
+    sort(expected.begin(), expected.end());
+    for (size_t e = 1; e < engines.size(); e++) {
+        vector<string_view> check = tokens;
+        engines[e].second(check);
+        if (check != expected) {
+            cerr << engines[e].first << " produced a different order than std::sort!" << endl;
+            return 1;
+        }
+    }
+
+    FILE* file = fopen(RESULT_FILE, "w");
+    if (file == NULL) {
+        cerr << "Error opening file for writing results!" << endl;
+        return 1;
+    }
+    fprintf(file, "Tokens,Bytes");
+    for (const auto& engine : engines) bench_csv_header(file, engine.first.c_str());
+    fprintf(file, "\n");
+
+    BenchConfig config = bench_default_config();
+    bench_pin_to_cpu(0);
+    for (int step = 1; step <= SWEEP_STEPS; step++) {
+        size_t count = tokens.size() * step / SWEEP_STEPS;
+        size_t bytes = 0;
+        for (size_t i = 0; i < count; i++) bytes += tokens[i].size();
+
+        fprintf(file, "%zu,%zu", count, bytes);
+        cout << "Tokens: " << count;
+        for (const auto& engine : engines) {
+            SortRun run = {&tokens, {}, count, engine.second};
+            BenchStats stats;
+            bench_measure(&config, prepare_sort_run, run_sort_run, &run, &stats);
+            bench_csv_stats(file, &stats);
+            cout << " | " << engine.first << ": " << stats.median_ms << " ms";
+        }
+        fprintf(file, "\n");
+        cout << endl;
+    }
+    fclose(file);
+    cout << "String sort benchmark complete. Results saved in " << RESULT_FILE << "." << endl;
+    return 0;
+}
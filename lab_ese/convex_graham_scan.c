@@ -105,6 +105,48 @@ void convexHull(Point points[], int n) {
         printf("(%d, %d)\n", hull[i].x, hull[i].y);
 }
 
+// Lexicographic (x, y) order for the monotone chain; needs no global point
+int compareXY(const void *vp1, const void *vp2) {
+    const Point *p1 = (const Point *)vp1;
+    const Point *p2 = (const Point *)vp2;
+    if (p1->x != p2->x) return (p1->x < p2->x) ? -1 : 1;
+    return (p1->y > p2->y) - (p1->y < p2->y);
+}
+
+// Andrew's monotone chain: reentrant alternative to convexHull (no p0).
+// Builds the lower chain left to right and the upper chain right to left,
+// dropping every non-left turn, so collinear boundary points are skipped.
+void convexHullMonotoneChain(Point points[], int n) {
+    qsort(points, n, sizeof(Point), compareXY);
+
+    Point *hull = (Point*)malloc(2 * n * sizeof(Point));
+    if (!hull) {
+        printf("Memory allocation failed.\n");
+        return;
+    }
+    int k = 0;
+    for (int i = 0; i < n; i++) {
+        while (k >= 2 && orientation(hull[k-2], hull[k-1], points[i]) != 2)
+            k--;
+        hull[k++] = points[i];
+    }
+    for (int i = n-2, lower = k+1; i >= 0; i--) {
+        while (k >= lower && orientation(hull[k-2], hull[k-1], points[i]) != 2)
+            k--;
+        hull[k++] = points[i];
+    }
+    k--; // the last point repeats the first
+
+    if (k < 3) {
+        printf("Convex hull not possible!\n");
+    } else {
+        printf("\nPoints in the Convex Hull:\n");
+        for (int i = 0; i < k; i++)
+            printf("(%d, %d)\n", hull[i].x, hull[i].y);
+    }
+    free(hull);
+}
+
 int main() {
     int n;
     printf("Enter the number of points: ");
@@ -128,6 +170,7 @@ int main() {
     }
     
     convexHull(points, n);
+    // convexHullMonotoneChain(points, n);
     
     free(points);
     return 0;
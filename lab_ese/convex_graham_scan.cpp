@@ -2,8 +2,10 @@
 // https://www.geeksforgeeks.org/orientation-3-ordered-points/
 // for explanation of orientation()
 #include <iostream>
+#include <algorithm>
 #include <stack>
 #include <stdlib.h>
+#include <vector>
 using namespace std;
 
 struct Point {
@@ -104,8 +106,10 @@ void convexHull(Point points[], int n) {
 
   // If modified array of points has less than 3 points,
   // convex hull is not possible
-  if (m < 3)
+  if (m < 3) {
+    cout << "Convex hull not possible!" << endl;
     return;
+  }
 
   // Create an empty stack and push first three points
   // to it.
@@ -132,10 +136,42 @@ void convexHull(Point points[], int n) {
   }
 }
 
+// Andrew's monotone chain: same hull without the global p0, so it is safe
+// to call from several threads at once. Points are sorted by (x, y); the
+// lower chain is built left to right and the upper chain right to left,
+// popping every non-left turn (collinear boundary points are dropped).
+void convexHullMonotoneChain(Point points[], int n) {
+  std::sort(points, points + n, [](const Point &a, const Point &b) {
+    return a.x < b.x || (a.x == b.x && a.y < b.y);
+  });
+
+  vector<Point> hull(2 * n);
+  int k = 0;
+  for (int i = 0; i < n; i++) {
+    while (k >= 2 && orientation(hull[k - 2], hull[k - 1], points[i]) != 2)
+      k--;
+    hull[k++] = points[i];
+  }
+  for (int i = n - 2, lower = k + 1; i >= 0; i--) {
+    while (k >= lower && orientation(hull[k - 2], hull[k - 1], points[i]) != 2)
+      k--;
+    hull[k++] = points[i];
+  }
+
+  // The last point repeats the first
+  if (k - 1 < 3) {
+    cout << "Convex hull not possible!" << endl;
+    return;
+  }
+  for (int i = 0; i < k - 1; i++)
+    cout << "(" << hull[i].x << ", " << hull[i].y << ")" << endl;
+}
+
 // Driver program to test above functions
 int main() {
   Point points[] = {{0, 3}, {1, 1}, {2, 2}, {4, 4}, {0, 0}, {1, 2}, {3, 1}, {3, 3}};
   int n = sizeof(points) / sizeof(points[0]);
   convexHull(points, n);
+  // convexHullMonotoneChain(points, n);
   return 0;
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
+#include <algorithm>
 #include <iostream>
 #include <vector>
+#include "../common/sort_network.h"
 using namespace std;
 #define MAX 100
 
@@ -61,21 +63,7 @@ void merge(vector<int>& arr, int s, int m, int e) {
 	for(int i = 0; i < n2; i++)
 		R[i] = arr[m + 1 + i];
 
-	int i = 0, j = 0, k = s;
-
-	while(i < n1 && j < n2) {
-		if(L[i] < R[j]) {
-			arr[k++] = L[i++];
-		} else {
-			arr[k++] = R[j++];
-		}
-	}
-	while(i < n1) {
-		arr[k++] = L[i++];
-	}
-	while(j < n2) {
-		arr[k++] = R[j++];
-	}
+	network_merge(L.data(), n1, R.data(), n2, arr.data() + s);
 }
 
 void merge_sort(vector<int>& arr, int s, int e) {
@@ -87,6 +75,89 @@ void merge_sort(vector<int>& arr, int s, int e) {
 	}
 }
 
+// Iterative merge sort with one scratch buffer; each pass merges from one
+// buffer into the other instead of copying back, so there is a single
+// allocation per sort instead of two per merge.
+void bottom_up_merge_sort(vector<int> &arr) {
+	int n = arr.size();
+	vector<int> buffer(n);
+	vector<int> *src = &arr, *dst = &buffer;
+	for(int width = 1; width < n; width *= 2) {
+		for(int s = 0; s < n; s += 2 * width) {
+			int m = min(s + width, n), e = min(s + 2 * width, n);
+			network_merge(src->data() + s, m - s, src->data() + m, e - m, dst->data() + s);
+		}
+		swap(src, dst);
+	}
+	if(src != &arr)
+		arr = *src;
+}
+
+// Stable in-place merge: the longer half is cut in the middle, the cut is
+// binary-searched in the other half, the blocks between the cuts trade
+// places with a rotation and both sides are merged again. No extra array.
+void rotation_merge(vector<int> &arr, int s, int m, int e) {
+	if(s >= m || m >= e || arr[m-1] <= arr[m])
+		return;
+	if(m - s == 1 && e - m == 1) {
+		swap(arr[s], arr[m]);
+		return;
+	}
+	int cut1, cut2;
+	if(m - s > e - m) {
+		cut1 = s + (m - s) / 2;
+		cut2 = lower_bound(arr.begin() + m, arr.begin() + e, arr[cut1]) - arr.begin();
+	} else {
+		cut2 = m + (e - m) / 2;
+		cut1 = upper_bound(arr.begin() + s, arr.begin() + m, arr[cut2]) - arr.begin();
+	}
+	rotate(arr.begin() + cut1, arr.begin() + m, arr.begin() + cut2);
+	int new_mid = cut1 + (cut2 - m);
+	rotation_merge(arr, s, cut1, new_mid);
+	rotation_merge(arr, new_mid, cut2, e);
+}
+
+void in_place_merge_sort(vector<int> &arr) {
+	int n = arr.size();
+	for(int width = 1; width < n; width *= 2)
+		for(int s = 0; s + width < n; s += 2 * width)
+			rotation_merge(arr, s, s + width, min(s + 2 * width, n));
+}
+
+// Picks the sort from the input and says which one it took. A single
+// descent can hide O(n^2) inversions (two sorted halves swapped), so input
+// with few runs goes to the bottom-up merge, not to insertion sort, which is
+// only used for small or already ordered input.
+void adaptive_sort(vector<int> &arr) {
+	int n = arr.size();
+	int descents = 0, ascents = 0;
+	for(int i = 1; i < n; i++) {
+		descents += arr[i] < arr[i-1];
+		ascents += arr[i] > arr[i-1];
+	}
+	const char *name, *reason;
+	if(n <= 16) {
+		name = "insertion sort", reason = "small input";
+		insertion_sort(arr);
+	} else if(descents == 0) {
+		name = "none", reason = "already sorted";
+	} else if(ascents == 0) {
+		name = "reverse", reason = "reverse sorted";
+		reverse(arr.begin(), arr.end());
+	} else if(descents <= n / 16) {
+		name = "bottom-up merge sort", reason = "few ascending runs";
+		bottom_up_merge_sort(arr);
+	} else if(ascents <= n / 16) {
+		name = "reverse + bottom-up merge sort", reason = "few descending runs";
+		reverse(arr.begin(), arr.end());
+		bottom_up_merge_sort(arr);
+	} else {
+		name = "merge sort", reason = "unordered input";
+		merge_sort(arr, 0, n-1);
+	}
+	cout << "Descents: " << descents << ", ascents: " << ascents << " -> " << name << " (" << reason << ")" << endl;
+}
+
 void print(vector<int> &arr){
 	for(auto &num: arr)
 		cout << num << " ";
@@ -108,13 +179,27 @@ int main() {
 		cin >> arr[i];
 	}
 
+	int choice;
+	do {
+		cout << "1. Insertion sort\n2. Selection sort\n3. Quick sort\n4. Merge sort\n5. Bottom-up merge sort\n6. In-place merge sort\n7. Adaptive (picks one of the above)\n";
+		cout << "Enter your choice: ";
+		cin >> choice;
+		if(choice<1 || choice>7)
+			cout << "Enter a valid input!" << endl;
+	} while (choice<1 || choice>7);
+
 	printf("\nBefore sorting: ");
 	print(arr);
 
-	// insertion_sort(arr);
-	// selection_sort(arr);
-	// quick_sort(arr, 0, n-1);
-	merge_sort(arr, 0, n-1);
+	switch(choice) {
+		case 1: insertion_sort(arr); break;
+		case 2: selection_sort(arr); break;
+		case 3: quick_sort(arr, 0, n-1); break;
+		case 4: merge_sort(arr, 0, n-1); break;
+		case 5: bottom_up_merge_sort(arr); break;
+		case 6: in_place_merge_sort(arr); break;
+		case 7: adaptive_sort(arr); break;
+	}
 
 	printf("After sorting: ");
 	print(arr);